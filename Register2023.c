@@ -5,16 +5,49 @@
  */
 
 
+#ifndef _WIN32
+#define _DEFAULT_SOURCE		// wait4 and the other BSD and POSIX functions with -std=c99
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include <time.h>
+#include <limits.h>
+#include <stdarg.h>
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600	// Condition variables need Windows Vista or later
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <errno.h>
+#endif
 
 #define breadth 1		// Constants denoting the four algorithms
 #define depth	2
 #define best	3
 #define astar	4
+#define bidirectional	5
+#define idastar	6
+#define iddfs	7
+#define hdastar	8
+#define arastar	9
+#define pbreadth	10
+#define portfolio	11
 
 #define increase 1		// Constants denoting the four algorithms
 #define decrease 2
@@ -23,6 +56,19 @@
 #define square	 5	// Constants denoting the four algorithms
 #define Root     6
 
+#define MAX_VALUE	1000000000	// The largest value of the problem
+
+#define FRONTIER_LIST	1	// Constants denoting the frontier used by best and astar
+#define FRONTIER_HEAP	2
+#define FRONTIER_BUCKET	3
+
+#define DUPLICATES_PATH		1	// Constants denoting the detection of repeated values
+#define DUPLICATES_CLOSED	2
+#define DUPLICATES_BITMAP	3	// A bitmap of all the values for breadth, the closed set for the other methods
+
+#define NODES_TREE	1	// Constants denoting the layout of the search tree of breadth and depth
+#define NODES_COMPACT	2
+
 
 struct tree_node
 {
@@ -33,6 +79,7 @@ struct tree_node
 	int f;				// f=0 or f=h or f=h+g, depending on the search algorithm used.
 	struct tree_node *parent;	// pointer to the parrent node (NULL for the root).
 	int operation;			// The operation of the last move
+	int next_operation;		// depth: the operators left to a node of the branch, -1 until it is expanded
 };
 
 // A node of the frontier. Frontier is kept as a double-linked list,
@@ -44,20 +91,607 @@ struct frontier_node
 	struct frontier_node *next;		// pointer to the next frontier node
 };
 
-struct frontier_node *frontier_head=NULL;	// The one end of the frontier
-struct frontier_node *frontier_tail=NULL;	// The other end of the frontier
+// An entry of the priority frontier. For best and astar the frontier is kept as
+// a binary min-heap instead of the ordered list, so that insertion and removal
+// cost O(log n). The sequence number reproduces the order of the list, where a
+// new node is placed before the older ones with equal f and h.
+struct heap_entry
+{
+	struct tree_node *n;	// pointer to a search-tree node
+	long seq;		// insertion order of the entry
+};
+
+struct node_heap
+{
+	struct heap_entry *entries;	// entries[0] is the best node
+	int size;			// Number of nodes in the heap
+	int capacity;			// Allocated entries
+	long seq;			// Sequence number of the next inserted node
+};
+
+#define BUCKET_WINDOW	262144	// Number of buckets of the bucket frontier (a power of two)
+
+// The bucket frontier of best and astar (Dial's buckets). f is a non-negative int, so
+// there is a bucket for every f of a window of BUCKET_WINDOW values, used as a circular
+// array. Each bucket is a list of frontier nodes in increasing order of h, where a new
+// node is placed before the older ones with the same h, as in add_frontier_in_order.
+// Adding a node only walks its bucket, and the first node is found by moving first
+// forward over the empty buckets. The nodes with an f outside of the window (the f of
+// best spans up to 10^9) are kept in the overflow heap, and the window moves to the f of
+// the new nodes whenever its buckets are empty.
+struct bucket_frontier
+{
+	struct frontier_node **buckets;	// The first node of the bucket of each f of the window
+	int base;			// The smallest f of the window
+	int first;			// No bucket below first holds a node
+	long count;			// Number of nodes in the buckets
+	struct node_heap overflow;	// The nodes with an f outside of the window
+};
+
+int frontier_kind=FRONTIER_HEAP;	// The frontier used by best and astar
+
+// An entry of the closed set. The closed set is a hash table with open addressing
+// that holds every value generated by the search, together with the smallest g
+// found for it, so that a repeated value is detected in O(1) no matter which path
+// reached it.
+struct closed_entry
+{
+	int node_value;		// the value of the node
+	int g;			// the smallest cost found for this value
+	struct tree_node *n;	// the node with this cost (NULL for an empty entry)
+};
+
+struct closed_set
+{
+	struct closed_entry *entries;
+	long capacity;		// Number of entries, always a power of two
+	long count;		// Number of used entries
+};
+
+int duplicate_kind=DUPLICATES_CLOSED;	// How repeated values are detected
+int node_kind=NODES_TREE;		// The layout of the search tree of breadth and depth
+
+// Search-tree nodes and frontier nodes are not allocated one by one. They are
+// taken from chunks of NODES_PER_CHUNK entries, and all the chunks of a search
+// are released together by end_search. Frontier nodes that leave the frontier,
+// and the search-tree nodes of depth whose children have been explored, are kept
+// in free lists and reused.
+#define NODES_PER_CHUNK	4096
+
+struct tree_chunk
+{
+	struct tree_chunk *next;			// the previously allocated chunk
+	int used;					// number of nodes given out from this chunk
+	struct tree_node nodes[NODES_PER_CHUNK];
+};
+
+struct frontier_chunk
+{
+	struct frontier_chunk *next;			// the previously allocated chunk
+	int used;					// number of nodes given out from this chunk
+	struct frontier_node nodes[NODES_PER_CHUNK];
+};
 
-clock_t t1;				// Start time of the search algorithm
-clock_t t2;				// End time of the search algorithm
 #define TIMEOUT		60	// Program terminates after TIMOUT secs
+#define ARA_WEIGHT	2.0	// The first weight of the heuristic of arastar
+#define ARA_WEIGHT_STEP	0.5	// The decrease of the weight after each solution of arastar
+#define BUDGET_CHECK_INTERVAL	256	// Expansions between two checks of the clock and the memory of a search
+
+#define STOP_TIME	1	// Constants denoting the budget that has stopped a search
+#define STOP_NODES	2
+#define STOP_MEMORY	3
+#define STOP_CANCEL	4	// Not a budget: another strategy of a portfolio has won
+
+#define EXIT_TIME	2	// Exit status of a search stopped by each budget
+#define EXIT_NODES	3
+#define EXIT_MEMORY	4
+
+struct path_step;
+
+#define BITMAP_WORDS	(MAX_VALUE/32+1)	// The 32-bit words of a bitmap of all the values
+#define DENSE_QUEUE	65536		// The first size of the queue of search_dense
+
+// A value reached by search_dense, with the cost of its path, so that the children that
+// would overflow it are not generated (see cost_fits), and the index in the queue of the
+// value it has been reached from (-1 for the root). The path is rebuilt from these
+// indices at the end.
+struct dense_entry
+{
+	int node_value;
+	int g;
+	int parent;
+};
+
+#define COMPACT_NODES	65536		// The first size of the arrays of a compact node store
+#define LINK_SHIFT	29		// The operation of a node is kept above the 29 bits of the index of its parent
+#define LINK_PARENT	((1u<<LINK_SHIFT)-1)
+#define COMPACT_MAX_NODES	((long) LINK_PARENT)	// The nodes that a compact node store can index
+
+// A set of values, without any node: a hash table with open addressing, where an empty
+// entry holds -1. It is the closed set of the compact node store, 4 bytes per entry.
+struct value_set
+{
+	int *values;
+	long capacity;		// Number of entries, always a power of two
+	long count;		// Number of used entries
+};
+
+// The search tree of breadth and depth with --nodes compact. The nodes are numbered in the
+// order they are created, the root is node 0, and each field is kept in its own array:
+// 12 bytes per node instead of a struct tree_node and a struct frontier_node. The depth,
+// h and f of a node are not kept, as breadth and depth do not use them, and are computed
+// for the nodes of the solution only. The frontier of breadth is the range of the nodes
+// from head on, as every new node is added at its back. depth only keeps its current
+// branch, node i being the parent of node i+1, and a stack of the operators left to
+// each node of the branch (see search_compact_depth).
+struct node_store
+{
+	int *values;		// The value of each node
+	int *g;			// The cost of each node
+	unsigned int *links;	// The index of the parent of each node, and its operation above LINK_SHIFT
+	long count;		// Number of nodes
+	long capacity;		// Size of the three arrays
+	long head;		// The first node of the frontier of breadth
+	int *stack;		// depth: the operators left to each node of the branch, -1 until it is expanded
+	long stack_size;
+	long stack_capacity;
+	struct value_set closed;	// The values generated (breadth) or expanded (depth)
+};
+
+// Counters of a search, reported with --stats and --stats-json.
+struct search_stats
+{
+	long expanded;				// Nodes expanded
+	long generated;				// Children generated by the operations
+	long duplicates;			// Children rejected as repeated values
+	long peak_frontier;			// Largest number of nodes in the frontier (see add_stats for several threads)
+	long bytes_allocated;			// Memory used by the nodes, the frontier and the closed set
+	long operations[Root+1];		// Children generated by each operation
+	double wall_time;			// Time spent on the search (wall clock)
+	double cpu_time;			// Processor time spent on the search, by all its threads
+	int stopped;				// The budget that has stopped the search (STOP_TIME...), 0 if none
+	int winner;				// The method whose solution a portfolio has returned, 0 if none
+};
+
+// The state of a search. Every search has its own context, so that several
+// searches can run at the same time in different threads.
+struct search_context;
+struct tree_node;
+
+// The expansion of a node, specialised for each method (see DEFINE_FIND_CHILDREN)
+typedef int (*find_children_function)(struct search_context *ctx, struct tree_node *current_node);
+
+struct search_context
+{
+	int method;				// The search algorithm
+	find_children_function find_children;	// The expansion of a node by this method
+	int initial_value;			// The value of the root
+	int target_value;			// The value that is searched for
+
+	struct frontier_node *frontier_head;	// The one end of the frontier
+	struct frontier_node *frontier_tail;	// The other end of the frontier
+
+	struct node_heap frontier_heap;		// The frontier of best and astar
+	struct bucket_frontier frontier_buckets;	// The frontier of best and astar with --frontier bucket
+	struct closed_set closed;		// The values generated by the search
+
+	struct node_heap backward_heap;		// The backward frontier of bidirectional
+	struct closed_set backward_closed;	// The values generated by the backward search
+	long meeting_cost;			// Cost of the best path found by bidirectional
+	struct tree_node *meeting_forward;	// The forward node of that path
+	struct tree_node *meeting_backward;	// The backward node with the same value
+
+	struct closed_set expanded;		// The values expanded by the current iteration of arastar
+	struct node_heap inconsistent;		// The nodes of arastar that wait for the next iteration
+	double weight;				// The weight of the heuristic of arastar
+	double suboptimality;			// The bound of the cost of the arastar solution over the optimum
+
+	struct tree_node *root;			// The root of the search tree
+	const unsigned short *target_landmarks;	// The landmark costs of the target, if astar uses them
+	struct path_step *path;			// The current path of idastar and iddfs
+	int path_capacity;			// The size of the path table
+	unsigned int *visited;			// The bitmap of the values reached by search_dense
+	struct dense_entry *queue;		// The values reached by search_dense, in the order of breadth
+	long queue_capacity;			// The size of the queue table
+	struct node_store store;		// The search tree of breadth and depth with --nodes compact
+
+	struct tree_chunk *tree_chunks;		// The chunk of the search tree in use
+	struct frontier_chunk *frontier_chunks;	// The chunk of the frontier in use
+	struct frontier_node *free_frontier_nodes;	// Frontier nodes that can be reused
+	struct tree_node *free_tree_nodes;	// Search-tree nodes that can be reused, linked by their parent
+
+	long *cancel;				// Set to non-zero to stop the search (see search_portfolio), NULL if none
+	int quiet;				// 1 if the search prints nothing (the methods of portfolio)
+	long expanded_nodes;			// Number of nodes expanded by the search
+	int budget_countdown;			// Expansions until the next check of the clock and the memory
+	double t1;				// Start time of the search algorithm (wall clock)
+	double t2;				// End time of the search algorithm (wall clock)
+	double c1;				// Processor time of the thread at the start of the search
+	double critical_time;			// pbreadth: the processor time of its slowest threads (see struct level_search)
+	int running;				// 1 from initialize_search to end_search
+	long frontier_size;			// Number of nodes in the frontier list
+	struct search_stats stats;
+
+	int solution_length;			// The lenght of the solution table.
+	struct tree_node *solution;		// Pointer to a dynamic table with the moves of the solution.
+	struct tree_node solution_root;		// A copy of the root, the parent of the first move.
+};
+
+int thread_count=1;			// Number of worker threads of the batch mode
+int search_threads=0;			// Number of threads of hdastar and pbreadth (0 for one per processor)
+double time_limit=TIMEOUT;		// Searches stop after time_limit secs (--timeout)
+long max_expanded=0;			// Searches stop after expanding max_expanded nodes, 0 for no limit (--max-expanded)
+long max_memory=0;			// Searches stop beyond max_memory bytes of search memory, 0 for no limit (--max-memory)
+double ara_weight=ARA_WEIGHT;		// The first weight of the heuristic of arastar (--weight)
+int stats_text=0;			// 1 if the statistics are printed after each query
+int binary_replies=0;			// 1 if the client and the load generator ask for binary replies (--format binary)
+FILE *stats_json=NULL;			// The file of the JSON statistics, if any
+
+#define MAX_PORTFOLIO	8	// The most methods of a portfolio
+
+#define PORTFOLIO_FIRST	1	// Constants denoting the solution returned by portfolio: the first one found
+#define PORTFOLIO_BEST	2	// or the cheapest one found within the time limit
+
+int portfolio_mode=PORTFOLIO_FIRST;	// The solution returned by portfolio (--portfolio)
+int portfolio_methods[MAX_PORTFOLIO]={best, astar, breadth, depth};	// The methods raced by portfolio (--portfolio-methods)
+int portfolio_count=4;
+
+#define TABLE_MAGIC		"R23TABLE"
+#define TABLE_VERSION		1
+#define TABLE_UNREACHABLE	0xFFFFFFFFu	// The cost of a value that cannot reach the target
+
+// The header of a precomputed table file. It is followed by the cost to the target of
+// every value from 0 to max_value (unsigned ints), and then by the operation that
+// moves each value towards the target (4 bits per value, two values per byte).
+struct table_header
+{
+	char magic[8];
+	int version;
+	int target_value;
+	int max_value;
+	int reserved;
+};
+
+// A precomputed table, mapped in memory. It is only read, so all the threads share it.
+struct solution_table
+{
+	void *base;			// The mapped file, NULL if there is no table
+	size_t size;
+	struct table_header *header;
+	unsigned int *costs;
+	unsigned char *operations;
+};
+
+struct solution_table table;		// The table given with --table
+
+#define LANDMARK_MAGIC		"R23LMARK"
+#define LANDMARK_VERSION	1
+#define MAX_LANDMARKS		16
+#define LANDMARK_UNREACHABLE	0xFFFF	// The stored cost between a value and a landmark that are not connected
+
+// The header of a landmark file. It is followed by the costs between every value from 0 to
+// max_value and each landmark, as unsigned shorts: for a value v, the cost from v to
+// landmark i is at 2*(v*count+i) and the cost from landmark i to v follows it, so that all
+// the costs of a value are read together. A cost is stored divided by the scale of its
+// landmark and direction, rounded down, so that it fits in 16 bits.
+struct landmark_header
+{
+	char magic[8];
+	int version;
+	int count;				// Number of landmarks
+	int max_value;
+	int reserved;
+	int values[MAX_LANDMARKS];		// The landmarks
+	unsigned int scales[MAX_LANDMARKS][2];	// The scales of the costs to and from each landmark
+};
+
+struct landmark_table
+{
+	void *base;			// The mapped file, NULL if there are no landmarks
+	size_t size;
+	struct landmark_header *header;
+	unsigned short *costs;
+};
+
+struct landmark_table landmarks;	// The landmarks given with --landmarks
+
+#define CACHE_MAGIC		"R23CACHE"
+#define CACHE_VERSION		2
+#define CACHE_SETS		1024	// The slots of the cache file, in sets of CACHE_WAYS slots
+#define CACHE_WAYS		8
+#define CACHE_MAX_STEPS		60	// Longer solutions are not cached
+
+// The header of a cache file. It is followed by CACHE_SETS*CACHE_WAYS slots.
+struct cache_header
+{
+	char magic[8];
+	int version;
+	int sets;
+	int ways;
+	int max_steps;
+	long long clock;			// Counts the stores and the hits, to evict the least recently used slot
+};
+
+// A move of a cached solution, as in the solution table of extract_solution.
+struct cache_step
+{
+	int node_value;
+	int g;
+	int operation;
+};
+
+// A cached solution. The sequence is odd while the slot is written: a reader that finds
+// the same even sequence before and after copying the slot has a consistent copy, so
+// readers never wait, and a writer gives up when another one holds the slot. The file is
+// shared by all the processes, so the fields have the same size on every system.
+struct cache_slot
+{
+	long long sequence;
+	long long last_used;			// The clock of the cache at the last store or hit
+	unsigned long long options;		// The hash of the options of the search (cache_options)
+	int method;
+	int initial_value;
+	int target_value;
+	int length;				// The number of moves, 0 for an empty slot
+	unsigned long long values;		// A bit for every value of the path (cache_bit), to skip slots quickly
+	struct cache_step steps[CACHE_MAX_STEPS];
+};
+
+// The cache file given with --cache, mapped in memory and shared by all the threads
+// and all the processes that use it.
+struct solution_cache
+{
+	void *base;				// The mapped file, NULL if there is no cache
+	size_t size;
+	struct cache_header *header;
+	struct cache_slot *slots;
+	long lookups;			// Counters of this process
+	long hits;
+	long subpath_hits;
+	long stores;
+};
+
+struct solution_cache cache;
+
+
+// Threads, mutexes and condition variables, on top of the Windows API or POSIX threads.
+#ifdef _WIN32
+typedef HANDLE thread_t;
+typedef CRITICAL_SECTION mutex_t;
+typedef CONDITION_VARIABLE cond_t;
+#define mutex_init(m)		InitializeCriticalSection(m)
+#define mutex_destroy(m)	DeleteCriticalSection(m)
+#define mutex_lock(m)		EnterCriticalSection(m)
+#define mutex_unlock(m)		LeaveCriticalSection(m)
+#define cond_init(c)		InitializeConditionVariable(c)
+#define cond_destroy(c)
+#define cond_wait(c,m)		SleepConditionVariableCS(c,m,INFINITE)
+#define cond_broadcast(c)	WakeAllConditionVariable(c)
+#define thread_yield()		SwitchToThread()
+#define atomic_add_long(p,v)	InterlockedExchangeAdd((volatile LONG*) (p),(v))
+#define atomic_load_long(p)	InterlockedCompareExchange((volatile LONG*) (p),0,0)
+#define atomic_store_long(p,v)	InterlockedExchange((volatile LONG*) (p),(v))
+#define atomic_load_pointer(p)	InterlockedCompareExchangePointer((PVOID volatile*) (p),NULL,NULL)
+#define atomic_swap_pointer(p,v)	InterlockedExchangePointer((PVOID volatile*) (p),(v))
+#define atomic_cas_pointer(p,old,new)	(InterlockedCompareExchangePointer((PVOID volatile*) (p),(new),(old))==(old))
+#define atomic_cas_long(p,old,new)	(InterlockedCompareExchange((volatile LONG*) (p),(new),(old))==(old))
+#define atomic_add_long_long(p,v)	InterlockedExchangeAdd64((volatile LONG64*) (p),(v))
+#define atomic_load_long_long(p)	InterlockedCompareExchange64((volatile LONG64*) (p),0,0)
+#define atomic_store_long_long(p,v)	InterlockedExchange64((volatile LONG64*) (p),(v))
+#define atomic_cas_long_long(p,old,new)	(InterlockedCompareExchange64((volatile LONG64*) (p),(new),(old))==(old))
+#define atomic_or_int(p,v)	((unsigned int) InterlockedOr((volatile LONG*) (p),(LONG) (v)))
+#define memory_fence()		MemoryBarrier()
+#else
+typedef pthread_t thread_t;
+typedef pthread_mutex_t mutex_t;
+typedef pthread_cond_t cond_t;
+#define mutex_init(m)		pthread_mutex_init(m,NULL)
+#define mutex_destroy(m)	pthread_mutex_destroy(m)
+#define mutex_lock(m)		pthread_mutex_lock(m)
+#define mutex_unlock(m)		pthread_mutex_unlock(m)
+#define cond_init(c)		pthread_cond_init(c,NULL)
+#define cond_destroy(c)		pthread_cond_destroy(c)
+#define cond_wait(c,m)		pthread_cond_wait(c,m)
+#define cond_broadcast(c)	pthread_cond_broadcast(c)
+#define thread_yield()		sched_yield()
+#define atomic_add_long(p,v)	__atomic_fetch_add((p),(v),__ATOMIC_SEQ_CST)
+#define atomic_load_long(p)	__atomic_load_n((p),__ATOMIC_SEQ_CST)
+#define atomic_store_long(p,v)	__atomic_store_n((p),(v),__ATOMIC_SEQ_CST)
+#define atomic_load_pointer(p)	__atomic_load_n((p),__ATOMIC_SEQ_CST)
+#define atomic_swap_pointer(p,v)	__atomic_exchange_n((p),(v),__ATOMIC_SEQ_CST)
+#define atomic_cas_pointer(p,old,new)	__atomic_compare_exchange_n((p),&(old),(new),0,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST)
+#define atomic_cas_long(p,old,new)	__atomic_compare_exchange_n((p),&(old),(new),0,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST)
+#define atomic_add_long_long(p,v)	atomic_add_long(p,v)
+#define atomic_load_long_long(p)	atomic_load_long(p)
+#define atomic_store_long_long(p,v)	atomic_store_long(p,v)
+#define atomic_cas_long_long(p,old,new)	atomic_cas_long(p,old,new)
+#define atomic_or_int(p,v)	__atomic_fetch_or((p),(v),__ATOMIC_RELAXED)
+#define memory_fence()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// The function and the argument of a new thread
+struct thread_start
+{
+	void (*function)(void*);
+	void *argument;
+};
+
+#ifdef _WIN32
+DWORD WINAPI thread_main(LPVOID p)
+#else
+void *thread_main(void *p)
+#endif
+{
+	struct thread_start start=*(struct thread_start*) p;
+	free(p);
+	start.function(start.argument);
+	return 0;
+}
+
+// This function starts a new thread that calls function(argument).
+// Output:
+//		0 --> The thread has been started
+//		-1 --> The thread cannot be started
+int thread_create(thread_t *thread, void (*function)(void*), void *argument)
+{
+	struct thread_start *start=(struct thread_start*) malloc(sizeof(struct thread_start));
+	if (start==NULL)
+		return -1;
+	start->function=function;
+	start->argument=argument;
+#ifdef _WIN32
+	*thread=CreateThread(NULL, 0, thread_main, start, 0, NULL);
+	if (*thread!=NULL)
+		return 0;
+#else
+	if (pthread_create(thread, NULL, thread_main, start)==0)
+		return 0;
+#endif
+	free(start);
+	return -1;
+}
+
+// This function waits for a thread to finish.
+void thread_join(thread_t thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+// A barrier: the threads that call barrier_wait wait until count threads have called it.
+struct barrier
+{
+	mutex_t lock;
+	cond_t all_arrived;
+	int count;			// The number of threads that meet at the barrier
+	int waiting;			// The number of threads that wait
+	long generation;		// Counts the times all the threads have met, so that a barrier can be reused
+};
+
+// This function prepares a barrier for count threads.
+void barrier_init(struct barrier *barrier, int count)
+{
+	mutex_init(&barrier->lock);
+	cond_init(&barrier->all_arrived);
+	barrier->count=count;
+	barrier->waiting=0;
+	barrier->generation=0;
+}
+
+// This function releases a barrier.
+void barrier_destroy(struct barrier *barrier)
+{
+	mutex_destroy(&barrier->lock);
+	cond_destroy(&barrier->all_arrived);
+}
+
+// This function waits until all the threads of a barrier have called it. The last thread
+// to arrive calls serial(argument), if serial is not NULL, before the others go on, so
+// that work that needs all the threads to be done runs without another barrier.
+void barrier_wait(struct barrier *barrier, void (*serial)(void*), void *argument)
+{
+	long generation;
+
+	mutex_lock(&barrier->lock);
+	generation=barrier->generation;
+	if (++barrier->waiting==barrier->count)
+	{
+		if (serial!=NULL)
+			serial(argument);
+		barrier->waiting=0;
+		barrier->generation++;
+		cond_broadcast(&barrier->all_arrived);
+	}
+	else
+		while (generation==barrier->generation)
+			cond_wait(&barrier->all_arrived, &barrier->lock);
+	mutex_unlock(&barrier->lock);
+}
+
+// Returns the number of processors of the machine.
+int cpu_count()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+#else
+	long n=sysconf(_SC_NPROCESSORS_ONLN);
+	return n>0 ? n : 1;
+#endif
+}
 
-int solution_length;	// The lenght of the solution table.
-struct tree_node *solution;		// Pointer to a dynamic table with the moves of the solution.
-int target_value; //The target value based on the arguments of the main call
-int initial_value; //The initial value based on the arguments of the main call
+// Returns the processor time in seconds used by the calling thread.
+double cpu_clock()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+		return 0;
+	return ((((unsigned long long) kernel.dwHighDateTime<<32) | kernel.dwLowDateTime) +
+		(((unsigned long long) user.dwHighDateTime<<32) | user.dwLowDateTime))/1e7;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+	return t.tv_sec+t.tv_nsec/1e9;
+#endif
+}
 
+// Returns the time in seconds from an arbitrary point, on a clock that is not affected
+// by the other threads (unlike clock(), which measures the processor time of the process).
+double wall_clock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double) counter.QuadPart/frequency.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec+t.tv_nsec/1e9;
+#endif
+}
 
 // Reading run-time parameters.
+int get_frontier_kind(char* s)
+{
+	if (strcmp(s,"heap")==0)
+		return FRONTIER_HEAP;
+	else if (strcmp(s,"list")==0)
+		return FRONTIER_LIST;
+	else if (strcmp(s,"bucket")==0)
+		return FRONTIER_BUCKET;
+	else
+		return -1;
+}
+
+int get_duplicate_kind(char* s)
+{
+	if (strcmp(s,"closed")==0)
+		return DUPLICATES_CLOSED;
+	else if (strcmp(s,"path")==0)
+		return DUPLICATES_PATH;
+	else if (strcmp(s,"bitmap")==0)
+		return DUPLICATES_BITMAP;
+	else
+		return -1;
+}
+
+int get_node_kind(char* s)
+{
+	if (strcmp(s,"tree")==0)
+		return NODES_TREE;
+	else if (strcmp(s,"compact")==0)
+		return NODES_COMPACT;
+	else
+		return -1;
+}
+
 int get_method(char* s)
 {
 	if (strcmp(s,"breadth")==0)
@@ -68,10 +702,70 @@ int get_method(char* s)
 		return best;
 	else if (strcmp(s,"astar")==0)
 		return astar;
+	else if (strcmp(s,"bidirectional")==0)
+		return bidirectional;
+	else if (strcmp(s,"idastar")==0)
+		return idastar;
+	else if (strcmp(s,"iddfs")==0)
+		return iddfs;
+	else if (strcmp(s,"hdastar")==0)
+		return hdastar;
+	else if (strcmp(s,"arastar")==0)
+		return arastar;
+	else if (strcmp(s,"pbreadth")==0)
+		return pbreadth;
+	else if (strcmp(s,"portfolio")==0)
+		return portfolio;
 	else
 		return -1;
 }
 
+// This function reads the comma-separated methods of --portfolio-methods into portfolio_methods.
+// Output:
+//		0 --> The methods have been read
+//		-1 --> A method is not valid, is portfolio itself, or there are more than MAX_PORTFOLIO
+int get_portfolio_methods(char* s)
+{
+	char list[256], *name;
+	int count=0;
+
+	if (strlen(s)>=sizeof(list))
+		return -1;
+	strcpy(list, s);
+	for (name=strtok(list,","); name!=NULL; name=strtok(NULL,","))
+	{
+		int method=get_method(name);
+		if (method<0 || method==portfolio || count==MAX_PORTFOLIO)
+			return -1;
+		portfolio_methods[count++]=method;
+	}
+	if (count==0)
+		return -1;
+	portfolio_count=count;
+	return 0;
+}
+
+// Returns the name of a method, as given in the command line.
+const char *method_name(int method)
+{
+	static const char *names[]={"", "breadth", "depth", "best", "astar", "bidirectional", "idastar", "iddfs", "hdastar",
+		"arastar", "pbreadth", "portfolio"};
+	if (method<1 || method>portfolio)
+		return "";
+	return names[method];
+}
+
+// Returns the name of a frontier, as given to --frontier.
+const char *frontier_name(int kind)
+{
+	switch (kind)
+	{
+		case FRONTIER_LIST:	return "list";
+		case FRONTIER_BUCKET:	return "bucket";
+		default:		return "heap";
+	}
+}
+
 // This function checks whether a node in the search tree
 // holds exactly the same puzzle with at least one of its
 // predecessors. This function is used when creating the childs
@@ -79,629 +773,6209 @@ int get_method(char* s)
 // whether this appears in the path from the root to its parent.
 // This is a moderate way to detect loops in the search.
 // Inputs:
-//		struct tree_node *new_node	: A search tree node (usually a new one)
+//		struct tree_node *parent	: The parent of the new node
+//		int node_value			: The value of the new node
 // Output:
 //		1 --> No coincidence with any predecessor
 //		0 --> Loop detection
-int check_with_parents(struct tree_node *new_node)
+int check_with_parents(struct tree_node *parent, int node_value)
 {
-	struct tree_node *parent=new_node->parent;
 	while (parent!=NULL)
 	{
-		if (new_node->node_value == parent->node_value)
+		if (node_value == parent->node_value)
 			return 0;
 		parent=parent->parent;
 	}
 	return 1;
 }
 
-// Giving a puzzle, this function computes the sum of the manhattan
-// distances between the current positions and the intended positions
-// for all the tiles of the puzzle.
-// Inputs:
-//		int p[N][N];	A puzzle
-// Output:
-//		As described above.
-int heuristic(long node_value)
+// Hash function of the closed set and of the value sets. The values are hashed in blocks
+// of 8 (Fibonacci hashing of value/8), and the values of a block stay next to each other,
+// so that the children of increase and decrease are looked up in the cache line of their
+// parent. The sets are at most half or three quarters full, so the blocks rarely overlap.
+unsigned long hash_value(int node_value)
 {
-	int i,j;
-	int score=0;
-	score=abs(target_value - node_value);
-	return score;
+	unsigned int block=(unsigned int) node_value>>3;
+	return ((((unsigned long) block * 2654435769UL) ^ (block >> 16)) << 3) | ((unsigned int) node_value & 7);
 }
 
+// This function returns the entry of the closed set that holds node_value,
+// or the empty entry where node_value should be stored.
+struct closed_entry *find_closed(struct closed_set *closed, int node_value)
+{
+	unsigned long i=hash_value(node_value) & (closed->capacity-1);
+	while (closed->entries[i].n!=NULL && closed->entries[i].node_value!=node_value)
+		i=(i+1) & (closed->capacity-1);
+	return &closed->entries[i];
+}
 
-// This function adds a pointer to a new leaf search-tree node at the front of the frontier.
-// This function is called by the depth-first search algorithm.
-// Inputs:
-//		struct tree_node *node	: A (leaf) search-tree node.
+// This function doubles the closed set (or creates it), so that it is never
+// more than half full.
 // Output:
-//		0 --> The new frontier node has been added successfully.
-//		-1 --> Memory problem when inserting the new frontier node .
-int add_frontier_front(struct tree_node *node)
+//		0 --> The closed set has been resized successfully.
+//		-1 --> Memory problem when resizing the closed set.
+int grow_closed_set(struct closed_set *closed)
 {
-	// Creating the new frontier node
-	struct frontier_node *new_frontier_node=(struct frontier_node*)
-                                malloc(sizeof(struct frontier_node));
-	if (new_frontier_node==NULL)
+	long i, old_capacity=closed->capacity;
+	struct closed_entry *old_entries=closed->entries;
+	long new_capacity = closed->capacity==0 ? 4096 : 2*closed->capacity;
+	struct closed_entry *new_entries=(struct closed_entry*) calloc(new_capacity, sizeof(struct closed_entry));
+	if (new_entries==NULL)
 		return -1;
 
-	new_frontier_node->n = node;
-	new_frontier_node->previous = NULL;
-	new_frontier_node->next = frontier_head;
+	closed->entries=new_entries;
+	closed->capacity=new_capacity;
+	for (i=0;i<old_capacity;i++)
+		if (old_entries[i].n!=NULL)
+			*find_closed(closed, old_entries[i].node_value)=old_entries[i];
+	free(old_entries);
+	return 0;
+}
 
-	if (frontier_head==NULL)
-	{
-		frontier_head=new_frontier_node;
-		frontier_tail=new_frontier_node;
-	}
-	else
+// This function returns the entry of the closed set for node_value, adding an empty
+// entry (with n==NULL) if the value is not in the set. The caller fills the new entry.
+// Output:
+//		The entry, or NULL in case of memory problem.
+struct closed_entry *add_closed(struct closed_set *closed, int node_value)
+{
+	struct closed_entry *entry;
+
+	if (2*(closed->count+1)>closed->capacity && grow_closed_set(closed)<0)
+		return NULL;
+	entry=find_closed(closed, node_value);
+	if (entry->n==NULL)
 	{
-		frontier_head->previous=new_frontier_node;
-		frontier_head=new_frontier_node;
+		entry->node_value=node_value;
+		closed->count++;
 	}
+	return entry;
+}
 
-	return 0;
+// This function returns the node recorded for node_value, or NULL if the value is not in the set.
+struct tree_node *lookup_closed(struct closed_set *closed, int node_value)
+{
+	if (closed->capacity==0)
+		return NULL;
+	return find_closed(closed, node_value)->n;
 }
 
-// This function adds a pointer to a new leaf search-tree node at the back of the frontier.
-// This function is called by the breadth-first search algorithm.
-// Inputs:
-//		struct tree_node *node	: A (leaf) search-tree node.
-// Output:
-//		0 --> The new frontier node has been added successfully.
-//		-1 --> Memory problem when inserting the new frontier node .
-int add_frontier_back(struct tree_node *node)
+// This function releases the entries of a closed set.
+void free_closed_set(struct closed_set *closed)
 {
-	// Creating the new frontier node
-	struct frontier_node *new_frontier_node=(struct frontier_node*) malloc(sizeof(struct frontier_node));
-	if (new_frontier_node==NULL)
-		return -1;
+	free(closed->entries);
+	closed->entries=NULL;
+	closed->capacity=0;
+	closed->count=0;
+}
 
-	new_frontier_node->n=node;
-	new_frontier_node->next=NULL;
-	new_frontier_node->previous=frontier_tail;
+// This function returns the entry of a value set that holds node_value,
+// or the empty entry where node_value should be stored.
+int *find_value(struct value_set *set, int node_value)
+{
+	unsigned long i=hash_value(node_value) & (set->capacity-1);
+	while (set->values[i]>=0 && set->values[i]!=node_value)
+		i=(i+1) & (set->capacity-1);
+	return &set->values[i];
+}
 
-	if (frontier_tail==NULL)
-	{
-		frontier_head=new_frontier_node;
-		frontier_tail=new_frontier_node;
-	}
-	else
+// This function adds a value to a value set, that is doubled (or created) when it would be
+// more than three quarters full.
+// Output:
+//		1 --> The value has been added
+//		0 --> The value was already in the set
+//		-1 --> Memory problem when resizing the set
+int add_value(struct value_set *set, int node_value)
+{
+	int *entry;
+
+	if (4*(set->count+1)>3*set->capacity)
 	{
-		frontier_tail->next=new_frontier_node;
-		frontier_tail=new_frontier_node;
+		long i, old_capacity=set->capacity;
+		int *old_values=set->values;
+		long new_capacity = set->capacity==0 ? 4096 : 2*set->capacity;
+		int *new_values=(int*) malloc(new_capacity*sizeof(int));
+		if (new_values==NULL)
+			return -1;
+		memset(new_values, 0xff, new_capacity*sizeof(int));
+		set->values=new_values;
+		set->capacity=new_capacity;
+		for (i=0;i<old_capacity;i++)
+			if (old_values[i]>=0)
+				*find_value(set, old_values[i])=old_values[i];
+		free(old_values);
 	}
+	entry=find_value(set, node_value);
+	if (*entry>=0)
+		return 0;
+	*entry=node_value;
+	set->count++;
+	return 1;
+}
 
-	return 0;
+// Returns 1 if a value is in a value set.
+int has_value(struct value_set *set, int node_value)
+{
+	return set->capacity>0 && *find_value(set, node_value)>=0;
 }
 
-// This function adds a pointer to a new leaf search-tree node within the frontier.
-// The frontier is always kept in increasing order wrt the f values of the corresponding
-// search-tree nodes. The new frontier node is inserted in order.
-// This function is called by the heuristic search algorithm.
+// This function releases the arrays of a compact node store.
+void free_node_store(struct node_store *store)
+{
+	free(store->values);
+	free(store->g);
+	free(store->links);
+	free(store->stack);
+	free(store->closed.values);
+	memset(store, 0, sizeof(struct node_store));
+}
+
+// This function checks the value of a new search tree node against the closed set,
+// before the node is created. A node is a duplicate if its value has already been
+// generated with the same or a smaller cost. For the breadth and best
+// methods every repeated value is a duplicate; astar reopens a value when
+// a cheaper path to it turns up. The depth method only records the values
+// it expands (see close_node), otherwise a value generated early in a
+// branch would cut every later path through it.
 // Inputs:
-//		struct tree_node *node	: A (leaf) search-tree node.
+//		int node_value, int g		: The value and the cost of the new node
+//		struct closed_entry **entry	: Set to the entry where the new node must be recorded
+//						  with record_closed, NULL for depth
 // Output:
-//		0 --> The new frontier node has been added successfully.
-//		-1 --> Memory problem when inserting the new frontier node .
-int add_frontier_in_order(struct tree_node *node)
+//		1 --> The node is not a duplicate
+//		0 --> The node is a duplicate
+//		-1 --> Memory problem when growing the closed set
+int check_with_closed(struct search_context *ctx, int node_value, int g, struct closed_entry **entry)
 {
-	// Creating the new frontier node
-	struct frontier_node *new_frontier_node=(struct frontier_node*)
-                malloc(sizeof(struct frontier_node));
-	if (new_frontier_node==NULL)
+	*entry=NULL;
+	if (ctx->method==depth)
+		return lookup_closed(&ctx->closed, node_value)==NULL;
+
+	*entry=add_closed(&ctx->closed, node_value);
+	if (*entry==NULL)
 		return -1;
+	if ((*entry)->n!=NULL && (ctx->method!=astar || (*entry)->g<=g))
+		return 0;
+	return 1;	// A new value, or reopening of a value of astar with a cheaper path
+}
 
-	new_frontier_node->n=node;
-	new_frontier_node->previous=NULL;
-	new_frontier_node->next=NULL;
+// This function records a new node in the entry of its value given by check_with_closed.
+void record_closed(struct closed_entry *entry, struct tree_node *node)
+{
+	if (entry==NULL)
+		return;
+	entry->g=node->g;
+	entry->n=node;
+}
 
-	if (frontier_head==NULL)
-	{
-		frontier_head=new_frontier_node;
-		frontier_tail=new_frontier_node;
-	}
-	else
-	{
-		struct frontier_node *pt;
-		pt=frontier_head;
+// This function is called for every node extracted from the frontier, before it is expanded.
+// A node of astar is skipped if a cheaper node with the same value has been added to
+// the frontier later, and a node of depth is skipped if its value has already been
+// expanded. Otherwise depth records the value in the closed set.
+// Output:
+//		1 --> The node must be expanded
+//		0 --> The node is stale and must be skipped
+//		-1 --> Memory problem when growing the closed set
+int close_node(struct search_context *ctx, struct tree_node *node)
+{
+	struct closed_entry *entry;
 
-		// Search in the frontier for the first node that corresponds to either a larger f value
-		// or to an equal f value but larger h value
-		// Note that for the best first search algorithm, f and h values coincide.
+	if (duplicate_kind==DUPLICATES_PATH || (ctx->method!=astar && ctx->method!=depth))
+		return 1;
+	if (ctx->method==astar)
+		return lookup_closed(&ctx->closed, node->node_value)==node;
+
+	entry=add_closed(&ctx->closed, node->node_value);
+	if (entry==NULL)
+		return -1;
+	if (entry->n!=NULL)
+		return 0;
+	entry->g=node->g;
+	entry->n=ctx->root;	// Only a mark, as the node itself is released once its children are explored
+	return 1;
+}
+
+// This function counts a child generated by an operation, and whether it has been
+// rejected as a repeated value.
+void count_child(struct search_context *ctx, int operation, int rejected)
+{
+	ctx->stats.generated++;
+	ctx->stats.operations[operation]++;
+	if (rejected)
+		ctx->stats.duplicates++;
+}
+
+// This function records the size of the frontier, to keep the largest one.
+void note_frontier_size(struct search_context *ctx, long size)
+{
+	if (size>ctx->stats.peak_frontier)
+		ctx->stats.peak_frontier=size;
+}
+
+// This function adds the counters of a search to the counters of another one. The peak
+// frontier is not added, as the peaks of two searches are not reached at the same time:
+// each caller decides what the peak of the whole search is.
+void add_stats(struct search_stats *to, struct search_stats *from)
+{
+	int i;
+
+	to->generated+=from->generated;
+	to->duplicates+=from->duplicates;
+	to->bytes_allocated+=from->bytes_allocated;
+	for (i=0;i<=Root;i++)
+		to->operations[i]+=from->operations[i];
+	to->cpu_time+=from->cpu_time;
+}
+
+// This function detects repeated values with the selected method:
+// the closed set (default) or the walk on the path to the root. The child is
+// checked before it is created, so that no node is created for a repeated value.
+// Inputs:
+//		struct tree_node *parent	: The node that is expanded
+//		int node_value, int g		: The value and the cost of the child
+//		int operation			: The operation that generates the child
+//		struct closed_entry **entry	: Set to the closed entry of the child (see check_with_closed)
+// Output:
+//		1 --> The node may be added to the frontier
+//		0 --> The node is a loop or a duplicate
+//		-1 --> Memory problem
+int check_duplicates(struct search_context *ctx, struct tree_node *parent, int node_value, int g, int operation,
+	struct closed_entry **entry)
+{
+	int err;
+
+	*entry=NULL;
+	if (duplicate_kind==DUPLICATES_PATH)
+		err=check_with_parents(parent, node_value);
+	else
+		err=check_with_closed(ctx, node_value, g, entry);
+	if (err>=0)
+		count_child(ctx, operation, err==0);
+	return err;
+}
+
+// Giving a puzzle, this function computes the sum of the manhattan
+// distances between the current positions and the intended positions
+// for all the tiles of the puzzle.
+// Inputs:
+//		int p[N][N];	A puzzle
+// Output:
+//		As described above.
+int heuristic(struct search_context *ctx, long node_value)
+{
+	int score=0;
+	score = node_value<ctx->target_value ? ctx->target_value-node_value : node_value-ctx->target_value;
+	return score;
+}
+
+// This function computes the landmark heuristic of astar, a lower bound of the cost from
+// a value v to the target t. By the triangle inequality, for every landmark L the cost
+// from v to t is at least cost(v,L)-cost(t,L) and cost(L,t)-cost(L,v). The stored costs
+// are rounded down, so one scale is taken off these bounds. The bound is at least a
+// quarter of the distance of v and t, since every operation costs at least a quarter of
+// the distance it moves.
+int landmark_heuristic(struct search_context *ctx, long node_value)
+{
+	const unsigned short *v=landmarks.costs+2*(size_t) node_value*landmarks.header->count;
+	const unsigned short *t=ctx->target_landmarks;
+	long bound=heuristic(ctx, node_value)/4, b;
+	int i, j;
+
+	for (i=0;i<2*landmarks.header->count;i++)
+	{
+		unsigned int scale=landmarks.header->scales[i/2][i%2];
+
+		if (v[i]==LANDMARK_UNREACHABLE || t[i]==LANDMARK_UNREACHABLE)
+			continue;
+		// Even entries are costs to the landmark (v before t), odd ones costs from it (t before v)
+		j = i%2==0 ? (int) v[i]-t[i] : (int) t[i]-v[i];
+		if (scale>1)
+			j--;
+		b=(long) j*scale;
+		if (b>bound)
+			bound=b;
+	}
+	return (int) bound;
+}
+
+// Returns 1 if a search uses the landmark heuristic: the method is astar or arastar, landmarks are
+// given, and the initial and target values are within their range (a negative target is accepted
+// by main and parse_query, but has no entry in the table).
+int uses_landmarks(struct search_context *ctx)
+{
+	return landmarks.base!=NULL && (ctx->method==astar || ctx->method==arastar) &&
+		ctx->initial_value>=0 && ctx->target_value>=0 &&
+		ctx->initial_value<=landmarks.header->max_value && ctx->target_value<=landmarks.header->max_value;
+}
+
+
+// This function returns a search-tree node, reused from the free list if possible,
+// or NULL if there is no memory for a new chunk.
+struct tree_node *alloc_tree_node(struct search_context *ctx)
+{
+	struct tree_node *node;
+
+	if (ctx->free_tree_nodes!=NULL)
+	{
+		node=ctx->free_tree_nodes;
+		ctx->free_tree_nodes=node->parent;
+		return node;
+	}
+	if (ctx->tree_chunks==NULL || ctx->tree_chunks->used==NODES_PER_CHUNK)
+	{
+		struct tree_chunk *chunk=(struct tree_chunk*) malloc(sizeof(struct tree_chunk));
+		if (chunk==NULL)
+			return NULL;
+		ctx->stats.bytes_allocated+=sizeof(struct tree_chunk);
+		chunk->next=ctx->tree_chunks;
+		chunk->used=0;
+		ctx->tree_chunks=chunk;
+	}
+	return &ctx->tree_chunks->nodes[ctx->tree_chunks->used++];
+}
+
+// This function gives back a node that is not used any more: a node of depth that has
+// been skipped, or whose children have all been explored (see search_depth).
+// The most recently allocated node goes back to its chunk, and the others to the free list.
+void release_tree_node(struct search_context *ctx, struct tree_node *node)
+{
+	if (ctx->tree_chunks!=NULL && ctx->tree_chunks->used>0 && node==&ctx->tree_chunks->nodes[ctx->tree_chunks->used-1])
+		ctx->tree_chunks->used--;
+	else
+	{
+		node->parent=ctx->free_tree_nodes;
+		ctx->free_tree_nodes=node;
+	}
+}
+
+// This function returns a frontier node, reused from the free list if possible,
+// or NULL if there is no memory for a new chunk.
+struct frontier_node *alloc_frontier_node(struct search_context *ctx)
+{
+	struct frontier_node *node;
+
+	note_frontier_size(ctx, ++ctx->frontier_size);
+	if (ctx->free_frontier_nodes!=NULL)
+	{
+		node=ctx->free_frontier_nodes;
+		ctx->free_frontier_nodes=node->next;
+		return node;
+	}
+	if (ctx->frontier_chunks==NULL || ctx->frontier_chunks->used==NODES_PER_CHUNK)
+	{
+		struct frontier_chunk *chunk=(struct frontier_chunk*) malloc(sizeof(struct frontier_chunk));
+		if (chunk==NULL)
+			return NULL;
+		ctx->stats.bytes_allocated+=sizeof(struct frontier_chunk);
+		chunk->next=ctx->frontier_chunks;
+		chunk->used=0;
+		ctx->frontier_chunks=chunk;
+	}
+	return &ctx->frontier_chunks->nodes[ctx->frontier_chunks->used++];
+}
+
+// This function puts a frontier node that has left the frontier into the free list.
+void free_frontier_node(struct search_context *ctx, struct frontier_node *node)
+{
+	node->next=ctx->free_frontier_nodes;
+	ctx->free_frontier_nodes=node;
+	ctx->frontier_size--;
+}
+
+// This function adds a pointer to a new leaf search-tree node at the front of the frontier.
+// This function is called by the depth-first search algorithm.
+// Inputs:
+//		struct tree_node *node	: A (leaf) search-tree node.
+// Output:
+//		0 --> The new frontier node has been added successfully.
+//		-1 --> Memory problem when inserting the new frontier node .
+int add_frontier_front(struct search_context *ctx, struct tree_node *node)
+{
+	// Creating the new frontier node
+	struct frontier_node *new_frontier_node=alloc_frontier_node(ctx);
+	if (new_frontier_node==NULL)
+		return -1;
+
+	new_frontier_node->n = node;
+	new_frontier_node->previous = NULL;
+	new_frontier_node->next = ctx->frontier_head;
+
+	if (ctx->frontier_head==NULL)
+	{
+		ctx->frontier_head=new_frontier_node;
+		ctx->frontier_tail=new_frontier_node;
+	}
+	else
+	{
+		ctx->frontier_head->previous=new_frontier_node;
+		ctx->frontier_head=new_frontier_node;
+	}
+
+	return 0;
+}
+
+// This function deletes the first node of the frontier list.
+void remove_frontier_front(struct search_context *ctx)
+{
+	struct frontier_node *temp_frontier_node=ctx->frontier_head;
+
+	ctx->frontier_head=ctx->frontier_head->next;
+	free_frontier_node(ctx, temp_frontier_node);
+	if (ctx->frontier_head==NULL)
+		ctx->frontier_tail=NULL;
+	else
+		ctx->frontier_head->previous=NULL;
+}
+
+// This function adds a pointer to a new leaf search-tree node at the back of the frontier.
+// This function is called by the breadth-first search algorithm.
+// Inputs:
+//		struct tree_node *node	: A (leaf) search-tree node.
+// Output:
+//		0 --> The new frontier node has been added successfully.
+//		-1 --> Memory problem when inserting the new frontier node .
+int add_frontier_back(struct search_context *ctx, struct tree_node *node)
+{
+	// Creating the new frontier node
+	struct frontier_node *new_frontier_node=alloc_frontier_node(ctx);
+	if (new_frontier_node==NULL)
+		return -1;
+
+	new_frontier_node->n=node;
+	new_frontier_node->next=NULL;
+	new_frontier_node->previous=ctx->frontier_tail;
+
+	if (ctx->frontier_tail==NULL)
+	{
+		ctx->frontier_head=new_frontier_node;
+		ctx->frontier_tail=new_frontier_node;
+	}
+	else
+	{
+		ctx->frontier_tail->next=new_frontier_node;
+		ctx->frontier_tail=new_frontier_node;
+	}
+
+	return 0;
+}
+
+// This function adds a pointer to a new leaf search-tree node within the frontier.
+// The frontier is always kept in increasing order wrt the f values of the corresponding
+// search-tree nodes. The new frontier node is inserted in order.
+// This function is called by the heuristic search algorithm.
+// Inputs:
+//		struct tree_node *node	: A (leaf) search-tree node.
+// Output:
+//		0 --> The new frontier node has been added successfully.
+//		-1 --> Memory problem when inserting the new frontier node .
+int add_frontier_in_order(struct search_context *ctx, struct tree_node *node)
+{
+	// Creating the new frontier node
+	struct frontier_node *new_frontier_node=alloc_frontier_node(ctx);
+	if (new_frontier_node==NULL)
+		return -1;
+
+	new_frontier_node->n=node;
+	new_frontier_node->previous=NULL;
+	new_frontier_node->next=NULL;
+
+	if (ctx->frontier_head==NULL)
+	{
+		ctx->frontier_head=new_frontier_node;
+		ctx->frontier_tail=new_frontier_node;
+	}
+	else
+	{
+		struct frontier_node *pt;
+		pt=ctx->frontier_head;
+
+		// Search in the frontier for the first node that corresponds to either a larger f value
+		// or to an equal f value but larger h value
+		// Note that for the best first search algorithm, f and h values coincide.
 		while (pt!=NULL && (pt->n->f<node->f || (pt->n->f==node->f && pt->n->h<node->h)))
 			pt=pt->next;
 
 		if (pt!=NULL)
 		{
-			// new_frontier_node is inserted before pt .
-			if (pt->previous!=NULL)
+			// new_frontier_node is inserted before pt .
+			if (pt->previous!=NULL)
+			{
+				pt->previous->next=new_frontier_node;
+				new_frontier_node->next=pt;
+				new_frontier_node->previous=pt->previous;
+				pt->previous=new_frontier_node;
+			}
+			else
+			{
+				// In this case, new_frontier_node becomes the first node of the frontier.
+				new_frontier_node->next=pt;
+				pt->previous=new_frontier_node;
+				ctx->frontier_head=new_frontier_node;
+			}
+		}
+		else
+		{
+			// if pt==NULL, new_frontier_node is inserted at the back of the frontier
+			ctx->frontier_tail->next=new_frontier_node;
+			new_frontier_node->previous=ctx->frontier_tail;
+			ctx->frontier_tail=new_frontier_node;
+		}
+	}
+
+	return 0;
+}
+
+// This function compares two heap entries with the ordering of add_frontier_in_order:
+// smaller f first, then smaller h, then the most recently inserted node.
+// Output:
+//		1 --> a must be extracted before b
+//		0 --> otherwise
+int heap_less(struct heap_entry *a, struct heap_entry *b)
+{
+	if (a->n->f!=b->n->f)
+		return a->n->f<b->n->f;
+	if (a->n->h!=b->n->h)
+		return a->n->h<b->n->h;
+	return a->seq>b->seq;
+}
+
+// This function adds a pointer to a search-tree node into a heap.
+// Inputs:
+//		struct node_heap *heap	: The heap
+//		struct tree_node *node	: A (leaf) search-tree node.
+// Output:
+//		0 --> The node has been added successfully.
+//		-1 --> Memory problem when growing the heap.
+int heap_push(struct node_heap *heap, struct tree_node *node)
+{
+	int i, parent;
+	struct heap_entry entry;
+
+	if (heap->size==heap->capacity)
+	{
+		int new_capacity = heap->capacity==0 ? 1024 : 2*heap->capacity;
+		struct heap_entry *new_entries=(struct heap_entry*)
+				realloc(heap->entries, new_capacity*sizeof(struct heap_entry));
+		if (new_entries==NULL)
+			return -1;
+		heap->entries=new_entries;
+		heap->capacity=new_capacity;
+	}
+
+	entry.n=node;
+	entry.seq=heap->seq++;
+
+	// Sift the new entry up from the last leaf
+	i=heap->size++;
+	while (i>0)
+	{
+		parent=(i-1)/2;
+		if (!heap_less(&entry, &heap->entries[parent]))
+			break;
+		heap->entries[i]=heap->entries[parent];
+		i=parent;
+	}
+	heap->entries[i]=entry;
+
+	return 0;
+}
+
+// This function removes the first node of a heap.
+// The last leaf is moved to the root and sifted down.
+void heap_pop(struct node_heap *heap)
+{
+	int i, child;
+	struct heap_entry last;
+
+	if (heap->size==0)
+		return;
+	last=heap->entries[--heap->size];
+
+	i=0;
+	while ((child=2*i+1)<heap->size)
+	{
+		if (child+1<heap->size && heap_less(&heap->entries[child+1], &heap->entries[child]))
+			child++;
+		if (!heap_less(&heap->entries[child], &last))
+			break;
+		heap->entries[i]=heap->entries[child];
+		i=child;
+	}
+	heap->entries[i]=last;
+}
+
+// This function releases the entries of a heap.
+void free_heap(struct node_heap *heap)
+{
+	free(heap->entries);
+	memset(heap, 0, sizeof(struct node_heap));
+}
+
+// This function adds a pointer to a new leaf search-tree node into the heap frontier.
+// This function is called by the heuristic search algorithms when frontier_kind is FRONTIER_HEAP.
+int add_frontier_heap(struct search_context *ctx, struct tree_node *node)
+{
+	if (heap_push(&ctx->frontier_heap, node)<0)
+		return -1;
+	note_frontier_size(ctx, ctx->frontier_heap.size);
+	return 0;
+}
+
+// This function adds a pointer to a new leaf search-tree node into the bucket frontier.
+// This function is called by the heuristic search algorithms when frontier_kind is FRONTIER_BUCKET.
+// Output:
+//		0 --> The new frontier node has been added successfully.
+//		-1 --> Memory problem when inserting the new frontier node.
+int add_frontier_bucket(struct search_context *ctx, struct tree_node *node)
+{
+	struct bucket_frontier *frontier=&ctx->frontier_buckets;
+	struct frontier_node *new_frontier_node, **pt;
+
+	if (frontier->buckets==NULL)
+	{
+		frontier->buckets=(struct frontier_node**) calloc(BUCKET_WINDOW, sizeof(struct frontier_node*));
+		if (frontier->buckets==NULL)
+			return -1;
+	}
+
+	// The window is moved to the new node when its buckets are empty, with some room
+	// below it, since the f of best and astar may decrease along a path
+	if (frontier->count==0 && (node->f<frontier->base || (long) node->f-frontier->base>=BUCKET_WINDOW))
+	{
+		frontier->base = node->f>BUCKET_WINDOW/4 ? node->f-BUCKET_WINDOW/4 : 0;
+		frontier->first=node->f;
+	}
+
+	if (node->f<frontier->base || (long) node->f-frontier->base>=BUCKET_WINDOW)
+	{
+		if (heap_push(&frontier->overflow, node)<0)
+			return -1;
+		note_frontier_size(ctx, ctx->frontier_size+frontier->overflow.size);
+		return 0;
+	}
+
+	new_frontier_node=alloc_frontier_node(ctx);
+	if (new_frontier_node==NULL)
+		return -1;
+	note_frontier_size(ctx, ctx->frontier_size+frontier->overflow.size);
+
+	// Search in the bucket for the first node with a larger or equal h
+	pt=&frontier->buckets[node->f & (BUCKET_WINDOW-1)];
+	while (*pt!=NULL && (*pt)->n->h<node->h)
+		pt=&(*pt)->next;
+	new_frontier_node->n=node;
+	new_frontier_node->previous=NULL;
+	new_frontier_node->next=*pt;
+	*pt=new_frontier_node;
+
+	if (frontier->count==0 || node->f<frontier->first)
+		frontier->first=node->f;
+	frontier->count++;
+	return 0;
+}
+
+// This function finds the first node of the bucket frontier, that must not be empty.
+// Output:
+//		The bucket of the first node, or NULL if it is the first node of the overflow heap.
+struct frontier_node **first_bucket(struct bucket_frontier *frontier)
+{
+	struct frontier_node **bucket;
+	struct tree_node *n;
+
+	if (frontier->count==0)
+		return NULL;
+	while (frontier->buckets[frontier->first & (BUCKET_WINDOW-1)]==NULL)
+		frontier->first++;
+	bucket=&frontier->buckets[frontier->first & (BUCKET_WINDOW-1)];
+	if (frontier->overflow.size==0)
+		return bucket;
+	n=frontier->overflow.entries[0].n;
+	if (n->f<(*bucket)->n->f || (n->f==(*bucket)->n->f && n->h<(*bucket)->n->h))
+		return NULL;
+	return bucket;
+}
+
+// Returns the first node of the bucket frontier, that must not be empty.
+struct tree_node *first_bucket_node(struct bucket_frontier *frontier)
+{
+	struct frontier_node **bucket=first_bucket(frontier);
+	return bucket!=NULL ? (*bucket)->n : frontier->overflow.entries[0].n;
+}
+
+// This function removes the first node of the bucket frontier, that must not be empty.
+void remove_first_bucket_node(struct search_context *ctx)
+{
+	struct bucket_frontier *frontier=&ctx->frontier_buckets;
+	struct frontier_node **bucket=first_bucket(frontier);
+	struct frontier_node *first;
+
+	if (bucket==NULL)
+	{
+		heap_pop(&frontier->overflow);
+		return;
+	}
+	first=*bucket;
+	*bucket=first->next;
+	frontier->count--;
+	free_frontier_node(ctx, first);
+}
+
+// This function releases the buckets and the overflow heap of a bucket frontier.
+void free_buckets(struct bucket_frontier *frontier)
+{
+	free(frontier->buckets);
+	free_heap(&frontier->overflow);
+	memset(frontier, 0, sizeof(struct bucket_frontier));
+}
+
+// Returns 1 if the given method keeps its frontier in the heap.
+int uses_heap(int method)
+{
+	return (frontier_kind==FRONTIER_HEAP && (method==best || method==astar)) || method==bidirectional;
+}
+
+// Returns 1 if the given method keeps its frontier in the buckets.
+int uses_buckets(int method)
+{
+	return frontier_kind==FRONTIER_BUCKET && (method==best || method==astar);
+}
+
+// Returns 1 if a method is solved by search_dense: breadth with --duplicates bitmap.
+int uses_dense(int method)
+{
+	return method==breadth && duplicate_kind==DUPLICATES_BITMAP;
+}
+
+// Returns 1 if a method keeps its search tree in the compact node store (--nodes compact).
+int uses_compact(int method)
+{
+	return node_kind==NODES_COMPACT && (method==breadth || method==depth) && !uses_dense(method);
+}
+
+//This functions calculated the f function for astar method
+int f(int g,int h,int method){
+	if(method==astar || method==idastar) return g+h/2;
+	if(method==hdastar) return g+h/4;	// Admissible and consistent, so hdastar is optimal
+	 return 0;
+	
+	}
+// A move from a value: the operation, the value it leads to and its cost.
+struct move
+{
+	int operation;
+	int node_value;
+	int cost;
+};
+
+#define MAX_MOVES	7	// At most 6 successors, or 7 predecessors (half has two)
+
+// A value of the current path of idastar and iddfs, with the moves that can be
+// applied to it and the next one to try.
+struct path_step
+{
+	int node_value;
+	int g;
+	int operation;		// The operation that leads to this value
+	int move_count;
+	int next_move;
+	struct move moves[MAX_MOVES];
+};
+
+// This function returns the integer square root of a value, i.e. the largest root
+// with root*root<=node_value, computed bit by bit without floating point.
+long long isqrt(long long node_value)
+{
+	long long root=0, bit=1LL<<62;
+
+	if (node_value<=0)
+		return 0;
+	while (bit>node_value)
+		bit>>=2;
+	while (bit!=0)
+	{
+		if (node_value>=root+bit)
+		{
+			node_value-=root+bit;
+			root=(root>>1)+bit;
+		}
+		else
+			root>>=1;
+		bit>>=2;
+	}
+	return root;
+}
+
+// Returns 1 if a value is a perfect square, with its square root in *root.
+int perfect_square(long long node_value, long long *root)
+{
+	*root=isqrt(node_value);
+	return *root * *root==node_value;
+}
+
+// This function multiplies two non-negative numbers.
+// Output:
+//		1 --> *product is a*b
+//		0 --> a*b does not fit in 64 bits
+int checked_multiply(long long a, long long b, long long *product)
+{
+	if (a!=0 && b>LLONG_MAX/a)
+		return 0;
+	*product=a*b;
+	return 1;
+}
+
+// Returns 1 if the cost of an operation can be added to the cost g of a path,
+// i.e. the cost of the new path still fits in an int.
+int cost_fits(long long g, long long cost)
+{
+	return g+cost<=INT_MAX;
+}
+
+// The operators of the problem, in the order their children are generated. Each entry is
+// X(operation, name, applicable, value, cost): the operation can be applied to a value x
+// when applicable holds, and then leads to value at the given cost. y is a long long that
+// applicable may set (the root or the square of x), and all the arithmetic is done on
+// 64 bits. A new operator is added with a new entry here, and with its inverse moves in
+// predecessors for bidirectional and precompute.
+#define OPERATORS(X) \
+	X(Root,		"root",		x>1 && perfect_square(x, &y),				y,	(x-y)/4+1) \
+	X(square,	"square",	x>1 && checked_multiply(x, x, &y) && y<=MAX_VALUE,	y,	(y-x)/4+1) \
+	X(half,		"half",		x>0,							x/2,	x/4+1) \
+	X(Double,	"double",	x>0 && 2*x<=MAX_VALUE,					2*x,	x/2+1) \
+	X(decrease,	"decrease",	x>0,							x-1,	2) \
+	X(increase,	"increase",	x<MAX_VALUE,						x+1,	2)
+
+// One move of successors, for an entry of OPERATORS.
+#define SUCCESSOR_MOVE(op, op_name, op_applicable, op_value, op_cost) \
+	if (op_applicable) \
+	{ \
+		moves[n].operation=op; \
+		moves[n].node_value=(op_value); \
+		moves[n++].cost=(op_cost); \
+	}
+
+// This function generates the moves that can be applied to a value, with the same
+// rules and costs as find_children and in the same order. All the values stay within
+// 0..MAX_VALUE.
+// Output:
+//		The number of moves.
+int successors(int node_value, struct move *moves)
+{
+	int n=0;
+	long long x=node_value, y;
+
+	OPERATORS(SUCCESSOR_MOVE)
+	return n;
+}
+
+// One case of successor, for an entry of OPERATORS.
+#define SUCCESSOR_CASE(op, op_name, op_applicable, op_value, op_cost) \
+	case op: \
+		if (!(op_applicable)) \
+			return 0; \
+		move->operation=op; \
+		move->node_value=(op_value); \
+		move->cost=(op_cost); \
+		return 1;
+
+// This function generates the move of one operation, as successors does for all of them.
+// Output:
+//		1 --> The operation can be applied to the value
+//		0 --> It cannot
+int successor(int node_value, int operation, struct move *move)
+{
+	long long x=node_value, y;
+
+	switch (operation)
+	{
+		OPERATORS(SUCCESSOR_CASE)
+	}
+	return 0;
+}
+
+// This function generates the inverse moves of a value: every value u from which an
+// operation leads to node_value. The operation and the cost of each move are those
+// of the operation applied to u, as in successors. The inverses are written by hand,
+// since they cannot be derived from OPERATORS (half has two of them).
+// Output:
+//		The number of moves.
+int predecessors(int node_value, struct move *moves)
+{
+	int n=0;
+	long long v=node_value, u;
+
+	// root of v*v gives v
+	if (v>1 && checked_multiply(v, v, &u) && u<=MAX_VALUE)
+	{
+		moves[n].operation=Root;
+		moves[n].node_value=u;
+		moves[n++].cost=(u-v)/4+1;
+	}
+	// square of the root of v gives v
+	if (v>1 && perfect_square(v, &u))
+	{
+		moves[n].operation=square;
+		moves[n].node_value=u;
+		moves[n++].cost=(v-u)/4+1;
+	}
+	// half of 2v and of 2v+1 gives v
+	if (v>0 && 2*v<=MAX_VALUE)
+	{
+		u=2*v;
+		moves[n].operation=half;
+		moves[n].node_value=u;
+		moves[n++].cost=u/4+1;
+	}
+	if (v>=0 && 2*v+1<=MAX_VALUE)
+	{
+		u=2*v+1;
+		moves[n].operation=half;
+		moves[n].node_value=u;
+		moves[n++].cost=u/4+1;
+	}
+	// double of v/2 gives v
+	if (v>0 && v%2==0)
+	{
+		u=v/2;
+		moves[n].operation=Double;
+		moves[n].node_value=u;
+		moves[n++].cost=u/2+1;
+	}
+	// decrease of v+1 gives v
+	if (v>=0 && v<MAX_VALUE)
+	{
+		moves[n].operation=decrease;
+		moves[n].node_value=v+1;
+		moves[n++].cost=2;
+	}
+	// increase of v-1 gives v
+	if (v>0)
+	{
+		moves[n].operation=increase;
+		moves[n].node_value=v-1;
+		moves[n++].cost=2;
+	}
+	return n;
+}
+
+// The expansion of a node by one operator, for an entry of OPERATORS. The child is
+// checked for loops and duplicates, and only then created and added to the frontier.
+// CHILD_F and ADD_CHILD, the f of the child and the frontier it goes to, are defined for
+// each method before its find_children is generated, so that there is no test of the
+// method here, and so are CHILD_H, its heuristic, and CHILD_ADMITTED, the values the
+// search may visit.
+#define EXPAND_OPERATOR(op, op_name, op_applicable, op_value, op_cost) \
+	if ((op_applicable) && cost_fits(current_node->g, (op_cost)) && CHILD_ADMITTED(op_value)) \
+	{ \
+		struct closed_entry *entry; \
+		int value=(int) (op_value), g=current_node->g+(int) (op_cost); \
+		err=check_duplicates(ctx, current_node, value, g, op, &entry); \
+		if (err<0) \
+			return -1; \
+		if (err>0)	/* No node is created for a loop or a duplicate */ \
+		{ \
+			struct tree_node *child=alloc_tree_node(ctx); \
+			if (child==NULL) \
+				return -1; \
+			child->parent=current_node; \
+			child->operation=op; \
+			child->node_value=value; \
+			child->node_depth=current_node->node_depth+1; \
+			child->g=g; \
+			record_closed(entry, child); \
+			child->h=CHILD_H(value); \
+			child->f=CHILD_F(child); \
+			if (ADD_CHILD(ctx, child)<0) \
+				return -1; \
+		} \
+	}
+
+// This macro generates a find_children function, that expands a leaf-node of the search
+// tree with every operator of OPERATORS that can be applied to its value. The children
+// rejected as loops or duplicates are released, the others are added to the frontier.
+// Inputs:
+//		struct tree_node *current_node	: A leaf-node of the search tree.
+// Output:
+//		1 --> The node is expanded
+//		-1 --> Memory exhausted
+#define DEFINE_FIND_CHILDREN(function) \
+int function(struct search_context *ctx, struct tree_node *current_node) \
+{ \
+	long long x=current_node->node_value, y;	/* 64 bits, so that square cannot overflow */ \
+	int err; \
+\
+	OPERATORS(EXPAND_OPERATOR) \
+	return 1; \
+}
+
+// Every value may be visited, and h is the distance to the target, but with landmarks
+#define CHILD_H(value)		heuristic(ctx, value)
+#define CHILD_ADMITTED(value)	1
+
+// breadth and depth: f is not used, the frontier is the list
+#define CHILD_F(child)	0
+#define ADD_CHILD	add_frontier_back
+DEFINE_FIND_CHILDREN(find_children_breadth)
+#undef ADD_CHILD
+
+// The operations of OPERATORS, in their order
+#define OPERATION_OF(op, op_name, op_applicable, op_value, op_cost)	op,
+const int operator_order[]={ OPERATORS(OPERATION_OF) };
+#define OPERATOR_COUNT	((int) (sizeof(operator_order)/sizeof(operator_order[0])))
+
+// One case of find_next_child_depth, for an entry of OPERATORS
+#define EXPAND_NEXT_OPERATOR(op, op_name, op_applicable, op_value, op_cost) \
+	case op: \
+		EXPAND_OPERATOR(op, op_name, op_applicable, op_value, op_cost) \
+		break;
+
+// This function generates the next child of a node of depth, trying its operators from
+// the last one of OPERATORS to the first one, the order in which depth explores the
+// children when they are all added at once at the front of the frontier. The children
+// rejected as loops or duplicates are skipped.
+// Inputs:
+//		struct tree_node *current_node	: The last node of the branch, expanded.
+//		struct tree_node **next_child	: Set to the child, that extends the branch
+// Output:
+//		1 --> A child has been generated
+//		0 --> The node has no child left
+//		-1 --> Memory exhausted
+#define ADD_CHILD(ctx, child)	((*next_child=(child))->next_operation=-1, 0)
+int find_next_child_depth(struct search_context *ctx, struct tree_node *current_node, struct tree_node **next_child)
+{
+	long long x=current_node->node_value, y;	// 64 bits, so that square cannot overflow
+	int err;
+
+	*next_child=NULL;
+	while (*next_child==NULL && current_node->next_operation>0)
+		switch (operator_order[--current_node->next_operation])
+		{
+			OPERATORS(EXPAND_NEXT_OPERATOR)
+		}
+	return *next_child!=NULL;
+}
+#undef ADD_CHILD
+#undef CHILD_F
+
+// best: f is h, the frontier is the heap, the ordered list or the buckets
+#define CHILD_F(child)	(child)->h
+#define ADD_CHILD	add_frontier_heap
+DEFINE_FIND_CHILDREN(find_children_best_heap)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_in_order
+DEFINE_FIND_CHILDREN(find_children_best_list)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_bucket
+DEFINE_FIND_CHILDREN(find_children_best_bucket)
+#undef ADD_CHILD
+#undef CHILD_F
+
+// astar: f is g+h/2, the frontier is the heap, the ordered list or the buckets
+#define CHILD_F(child)	f((child)->g, (child)->h, astar)
+#define ADD_CHILD	add_frontier_heap
+DEFINE_FIND_CHILDREN(find_children_astar_heap)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_in_order
+DEFINE_FIND_CHILDREN(find_children_astar_list)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_bucket
+DEFINE_FIND_CHILDREN(find_children_astar_bucket)
+#undef ADD_CHILD
+#undef CHILD_F
+#undef CHILD_H
+#undef CHILD_ADMITTED
+
+// astar with landmarks: h is the landmark bound, that is admissible, so f is g+h, and
+// the search stays within the range of the landmarks
+#define CHILD_H(value)		landmark_heuristic(ctx, value)
+#define CHILD_ADMITTED(value)	((value)<=landmarks.header->max_value)
+#define CHILD_F(child)	((child)->g+(child)->h)
+#define ADD_CHILD	add_frontier_heap
+DEFINE_FIND_CHILDREN(find_children_landmark_heap)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_in_order
+DEFINE_FIND_CHILDREN(find_children_landmark_list)
+#undef ADD_CHILD
+#define ADD_CHILD	add_frontier_bucket
+DEFINE_FIND_CHILDREN(find_children_landmark_bucket)
+#undef ADD_CHILD
+#undef CHILD_F
+#undef CHILD_H
+#undef CHILD_ADMITTED
+
+// This function chooses the find_children of the method of a search, of the frontier_kind
+// and of the landmarks. It is called once per search, by initialize_search.
+// Output:
+//		The find_children function, or NULL for the methods that do not use one.
+find_children_function select_find_children(struct search_context *ctx)
+{
+	switch (ctx->method)
+	{
+		case breadth:	return find_children_breadth;
+		case best:
+			if (frontier_kind==FRONTIER_BUCKET)
+				return find_children_best_bucket;
+			return frontier_kind==FRONTIER_HEAP ? find_children_best_heap : find_children_best_list;
+		case astar:
+			if (ctx->target_landmarks!=NULL)
+			{
+				if (frontier_kind==FRONTIER_BUCKET)
+					return find_children_landmark_bucket;
+				return frontier_kind==FRONTIER_HEAP ? find_children_landmark_heap : find_children_landmark_list;
+			}
+			if (frontier_kind==FRONTIER_BUCKET)
+				return find_children_astar_bucket;
+			return frontier_kind==FRONTIER_HEAP ? find_children_astar_heap : find_children_astar_list;
+		default:	return NULL;
+	}
+}
+
+// Auxiliary function that displays a message in case of wrong input parameters.
+void syntax_message()
+{
+	printf("Syntax of the main call: \n");
+	printf("Register2023 [--frontier heap|list|bucket] [--duplicates closed|path|bitmap] [--nodes tree|compact] [--table <table-file>] [--landmarks <landmark-file>] <method> <initial number> <target value> <output-file>\n\n");
+	printf("where: ");
+	printf("<method> = breadth|depth|best|astar|bidirectional|idastar|iddfs|hdastar|arastar|pbreadth|portfolio\n");
+	printf("--frontier selects the frontier of best and astar: a binary heap (default), the ordered list,\n");
+	printf("           or buckets of the nodes with the same f.\n");
+	printf("--duplicates selects how repeated values are rejected: a closed set of all the generated values (default)\n");
+	printf("             or a check against the ancestors of each node, or for breadth, a bitmap of all the values\n");
+	printf("             and a queue of 12 bytes per value, for searches that reach hundreds of millions of values.\n");
+	printf("--nodes selects the layout of the search tree of breadth and depth: a node and a frontier node\n");
+	printf("        per state (tree, default), or arrays of 12 bytes per node and a frontier of node indices (compact).\n");
+	printf("<initial number> is the positive integer number of the root of the tree.\n");
+	printf("<target value> is the positive integer target value of the search algorithm.\n");
+	printf("<output-file> is the output file where the solution and the steps will be extracted.\n");
+	printf("example : register.exe breadth 5 18 solution.txt.\n\n");
+	printf("Batch mode: Register2023 [--threads N] [options] batch <query-file> <output-file>\n");
+	printf("<query-file> has one query <method> <initial number> <target value> per line (- for the standard input).\n");
+	printf("The solutions of all the queries are written to <output-file> (- for the standard output),\n");
+	printf("in the order of the queries. --threads sets the number of worker threads (0 for one per processor).\n");
+	printf("One-to-many mode: Register2023 [options] targets <initial number> <target-file> <output-file>\n");
+	printf("finds the cheapest path from <initial number> to each target of <target-file> (one per line, - for the\n");
+	printf("standard input) with one uniform-cost search, and writes the solutions in the order of the targets.\n");
+	printf("Server mode (not on Windows): Register2023 [--threads N] [options] serve <socket-path>\n");
+	printf("answers the queries sent to the Unix domain socket <socket-path> with N workers, until it is interrupted.\n");
+	printf("A query <method> <initial number> <target value> gets the solution in the form of <output-file>, or\n");
+	printf("with binary at its end, the number of moves and the cost (32-bit integers) and one byte per operation.\n");
+	printf("Register2023 [--format text|binary] client <socket-path> <query-file> <output-file> sends the queries\n");
+	printf("of <query-file> to the server, and Register2023 [--format text|binary] loadgen <socket-path> <query-file>\n");
+	printf("<requests> <connections> sends <requests> queries over <connections> connections and prints the latencies.\n");
+	printf("Precompute mode: Register2023 precompute <target value> <max value> <table-file>\n");
+	printf("writes the cost to <target value> of every value from 0 to <max value> (at most 1000000000) to <table-file>.\n");
+	printf("With --table <table-file>, the queries to that target are answered from the table, without search.\n");
+	printf("With --cache <cache-file>, the solutions are kept in <cache-file> (created if needed) for the next runs,\n");
+	printf("and the queries of breadth, bidirectional and hdastar are also answered from parts of cached solutions.\n");
+	printf("Landmarks: Register2023 landmarks <count> <max value> <landmark-file> chooses up to %d landmarks\n",MAX_LANDMARKS);
+	printf("and writes the costs of every value from 0 to <max value> to and from them to <landmark-file>.\n");
+	printf("With --landmarks <landmark-file>, astar uses them for an admissible heuristic (f=g+h), and finds\n");
+	printf("the cheapest solution within 0..<max value> for the queries within that range.\n");
+	printf("--stats text prints the counters of each search, and --stats-json <file> appends them to <file>\n");
+	printf("as one JSON record per query (- for the standard output).\n");
+	printf("hdastar is a parallel astar with --search-threads N threads (0, the default, for one per processor).\n");
+	printf("Register2023 hdabench <initial number> <target value> <max threads> measures its speedup.\n");
+	printf("pbreadth is a parallel breadth with --search-threads N threads, that finds the same solution as breadth.\n");
+	printf("Register2023 levelbench <initial number> <target value> <max threads> measures its speedup.\n");
+	printf("portfolio runs the methods of --portfolio-methods (default best,astar,breadth,depth) at the same time,\n");
+	printf("and returns the first solution found (--portfolio first, default) or the cheapest one found within the\n");
+	printf("time limit (--portfolio best). The method that has won is printed and kept in the statistics.\n");
+	printf("arastar is an anytime astar: it finds a solution with the heuristic weighted by --weight W (default 2),\n");
+	printf("then improves it with lower weights, and returns the best solution and its bound when time is over.\n");
+	printf("--timeout sets the time limit of a search in secs (default 60), --max-expanded N the number of nodes\n");
+	printf("it may expand and --max-memory B the bytes of search memory it may use (B may end in K, M or G).\n");
+	printf("A search stopped by one of these budgets prints its statistics so far and the program exits with\n");
+	printf("status %d (time), %d (nodes) or %d (memory); in batch mode, the budget of the first query stopped.\n\n",
+		EXIT_TIME,EXIT_NODES,EXIT_MEMORY);
+	printf("Benchmark: Register2023 [--seed S] [--tolerance T] [--timeout secs] benchmark <baseline-file> <results-file>\n");
+	printf("runs every method, and best and astar with every frontier, on a corpus of cases generated from\n");
+	printf("the seed (default 2023), with a time limit\n");
+	printf("of 5 secs by default, and writes the time, nodes/sec, peak memory and cost of each run to <results-file>.\n");
+	printf("Runs that are slower or use more memory than T times the <baseline-file> (default 1.5), or that\n");
+	printf("solve a case worse, are flagged as regressions (- for no baseline).\n");
+}
+
+// This function reads a number of bytes, with an optional suffix K, M or G (powers of 1024).
+// Output:
+//		>0 --> The number of bytes
+//		-1 --> The number is not valid
+long parse_bytes(const char *s)
+{
+	char *p;
+	double bytes=strtod(s, &p);
+
+	if (*p=='K' || *p=='k')
+		bytes*=1024, p++;
+	else if (*p=='M' || *p=='m')
+		bytes*=1024*1024, p++;
+	else if (*p=='G' || *p=='g')
+		bytes*=1024.0*1024*1024, p++;
+	if (*p!='\0' || p==s || bytes<1 || bytes>LONG_MAX)
+		return -1;
+	return (long) bytes;
+}
+
+// This function checks whether a puzzle is a solution puzzle.
+// Inputs:
+//		int p[N][N]		: A puzzle
+// Outputs:
+//		1 --> The puzzle is a solution puzzle
+//		0 --> The puzzle is NOT a solution puzzle
+int is_solution(struct search_context *ctx, int node_value)
+{
+	if(node_value==ctx->target_value)return 1;
+	return 0;
+}
+
+// Giving a (solution) leaf-node of the search tree, this function computes
+// the moves of the blank that have to be done, starting from the root puzzle,
+// in order to go to the leaf node's puzzle.
+// Inputs:
+//		struct tree_node *solution_node	: A leaf-node
+// Output:
+//		The sequence of blank's moves that have to be done, starting from the root puzzle,
+//		in order to receive the leaf-node's puzzle, is stored into the solution of the context.
+//		The parent of each move points to the previous move (or to solution_root), so the
+//		solution remains valid after the search tree has been released by end_search.
+void extract_solution(struct search_context *ctx, struct tree_node *solution_node)
+{
+	int i;
+
+	struct tree_node *temp_node=solution_node;
+	ctx->solution_length = solution_node->node_depth;
+
+	free(ctx->solution);
+	ctx->solution= (struct tree_node*) malloc(ctx->solution_length*sizeof(struct tree_node));
+	temp_node=solution_node;
+	i=ctx->solution_length;
+	while (temp_node->parent!=NULL)
+	{
+		i--;
+		ctx->solution[i] = *temp_node;
+		ctx->solution[i].parent = i>0 ? &ctx->solution[i-1] : &ctx->solution_root;
+		temp_node=temp_node->parent;
+	}
+	ctx->solution_root=*temp_node;
+}
+
+// This function writes the solution into an open stream
+// Inputs:
+//		FILE *fout	: The stream where the solution will be written.
+// Outputs:
+//		Nothing (apart from the written lines)
+void print_solution(FILE *fout, int solution_length,struct tree_node *solution)
+{
+	int i;
+	fprintf(fout,"%d, %d\n",solution_length,solution_length>0 ? solution[solution_length-1].g : 0);
+	for (i=0;i<solution_length;i++)
+		switch(solution[i].operation)
+		{
+		case increase:
+			fprintf(fout,"increase %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g);
+			break;
+		case decrease:
+			fprintf(fout,"decrease %d %d\n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
+			break;
+		case Double:
+			fprintf(fout,"double %d %d\n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
+			break;
+		case half:
+			fprintf(fout,"half %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
+			break;
+		case square:
+			fprintf(fout,"square %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
+			break;
+		case Root:
+			fprintf(fout,"root %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g );
+			break;
+			
+			
+	}
+}
+
+// This function writes the solution into a file
+// Inputs:
+//		char* filename	: The name of the file where the solution will be written.
+// Outputs:
+//		Nothing (apart from the new file)
+void write_solution_to_file(char* filename, int solution_length,struct tree_node *solution)
+{
+	FILE *fout;
+	fout=fopen(filename,"w");
+	if (fout==NULL)
+	{
+		printf("Cannot open output file to write solution.\n");
+		printf("Now exiting...");
+		return;
+	}
+	print_solution(fout, solution_length, solution);
+	fclose(fout);
+}
+
+// Returns the name of the budget that has stopped a search, NULL if none.
+const char *stop_name(int stopped)
+{
+	if (stopped==STOP_TIME)
+		return "time";
+	if (stopped==STOP_NODES)
+		return "nodes";
+	if (stopped==STOP_MEMORY)
+		return "memory";
+	if (stopped==STOP_CANCEL)
+		return "cancel";
+	return NULL;
+}
+
+// This function prints the counters of a search.
+void print_stats(FILE *fout, struct search_stats *stats)
+{
+	if (stats->stopped)
+		fprintf(fout,"Stopped by the %s budget, partial counters:\n",stop_name(stats->stopped));
+	fprintf(fout,"Nodes expanded: %ld, generated: %ld, rejected as duplicates: %ld\n",
+		stats->expanded, stats->generated, stats->duplicates);
+	fprintf(fout,"Generated by increase: %ld, decrease: %ld, double: %ld, half: %ld, square: %ld, root: %ld\n",
+		stats->operations[increase], stats->operations[decrease], stats->operations[Double],
+		stats->operations[half], stats->operations[square], stats->operations[Root]);
+	fprintf(fout,"Peak frontier: %ld nodes, memory allocated: %ld bytes\n",stats->peak_frontier,stats->bytes_allocated);
+	if (stats->winner)
+		fprintf(fout,"Portfolio won by %s\n",method_name(stats->winner));
+	fprintf(fout,"Wall time: %f secs, CPU time: %f secs\n",stats->wall_time,stats->cpu_time);
+}
+
+// This function writes the counters of a query as a JSON record on one line.
+// Inputs:
+//		int query		: The number of the query (1 outside the batch mode)
+//		int found		: 1 if a solution has been found, with the given length and moves
+void write_stats_json(FILE *fout, int query, int method, int initial_value, int target_value,
+	int found, int solution_length, struct tree_node *solution, struct search_stats *stats)
+{
+	fprintf(fout,"{\"query\": %d, \"method\": \"%s\", \"initial\": %d, \"target\": %d, ",
+		query, method_name(method), initial_value, target_value);
+	if (found)
+		fprintf(fout,"\"solved\": true, \"steps\": %d, \"cost\": %d, ",
+			solution_length, solution_length>0 ? solution[solution_length-1].g : 0);
+	else
+		fprintf(fout,"\"solved\": false, \"steps\": null, \"cost\": null, ");
+	fprintf(fout,"\"expanded\": %ld, \"generated\": %ld, \"duplicates\": %ld, \"peak_frontier\": %ld, \"bytes_allocated\": %ld, ",
+		stats->expanded, stats->generated, stats->duplicates, stats->peak_frontier, stats->bytes_allocated);
+	fprintf(fout,"\"operations\": {\"increase\": %ld, \"decrease\": %ld, \"double\": %ld, \"half\": %ld, \"square\": %ld, \"root\": %ld}, ",
+		stats->operations[increase], stats->operations[decrease], stats->operations[Double],
+		stats->operations[half], stats->operations[square], stats->operations[Root]);
+	if (stats->stopped)
+		fprintf(fout,"\"stopped\": \"%s\", ",stop_name(stats->stopped));
+	else
+		fprintf(fout,"\"stopped\": null, ");
+	if (stats->winner)
+		fprintf(fout,"\"winner\": \"%s\", ",method_name(stats->winner));
+	fprintf(fout,"\"wall_time\": %f, \"cpu_time\": %f}\n", stats->wall_time, stats->cpu_time);
+	fflush(fout);
+}
+
+// This function initializes the bidirectional search: the root is the first node of the
+// forward frontier, and a node with the target value is the first node of the backward
+// frontier. In the backward search tree the parent of a node is the next node on the
+// way to the target, g is the cost to the target, and operation is the operation that
+// leads from the node to its parent.
+// Output:
+//		0 --> The search has been initialized
+//		-1 --> Memory problem
+int initialize_bidirectional(struct search_context *ctx, struct tree_node *root)
+{
+	struct tree_node *target=alloc_tree_node(ctx);
+	struct closed_entry *entry;
+
+	if (target==NULL)
+		return -1;
+	*target=*root;
+	target->node_value=ctx->target_value;
+	root->h=root->f=0;
+	target->h=target->f=0;
+
+	entry=add_closed(&ctx->closed, root->node_value);
+	if (entry==NULL)
+		return -1;
+	entry->g=0;
+	entry->n=root;
+	entry=add_closed(&ctx->backward_closed, target->node_value);
+	if (entry==NULL)
+		return -1;
+	entry->g=0;
+	entry->n=target;
+
+	ctx->meeting_cost=LONG_MAX;
+	ctx->meeting_forward=NULL;
+	ctx->meeting_backward=NULL;
+	if (root->node_value==target->node_value)
+	{
+		ctx->meeting_cost=0;
+		ctx->meeting_forward=root;
+		ctx->meeting_backward=target;
+	}
+
+	if (heap_push(&ctx->frontier_heap, root)<0 || heap_push(&ctx->backward_heap, target)<0)
+		return -1;
+	note_frontier_size(ctx, 2);
+	return 0;
+}
+
+// Returns the admissible heuristic of arastar: the landmark bound if the search uses the
+// landmarks, and otherwise a quarter of the distance to the target (see landmark_heuristic).
+int admissible_heuristic(struct search_context *ctx, int node_value)
+{
+	if (ctx->target_landmarks!=NULL)
+		return landmark_heuristic(ctx, node_value);
+	return heuristic(ctx, node_value)/4;
+}
+
+// Returns the f of a node of arastar: g plus the weighted heuristic, within an int.
+int weighted_f(struct search_context *ctx, struct tree_node *node)
+{
+	double value=node->g+ctx->weight*node->h;
+	return value<INT_MAX ? (int) value : INT_MAX;
+}
+
+// This function initializes arastar: the root is the first value of the closed set and of
+// the frontier, and the weight is the one of --weight.
+// Output:
+//		0 --> The search has been initialized
+//		-1 --> Memory problem
+int initialize_anytime(struct search_context *ctx, struct tree_node *root)
+{
+	struct closed_entry *entry;
+
+	ctx->weight=ara_weight;
+	ctx->suboptimality=0;
+	root->h=admissible_heuristic(ctx, root->node_value);
+	root->f=weighted_f(ctx, root);
+	entry=add_closed(&ctx->closed, root->node_value);
+	if (entry==NULL)
+		return -1;
+	entry->g=root->g;
+	entry->n=root;
+	return add_frontier_heap(ctx, root);
+}
+
+// This function initializes the search, i.e. it creates the root node of the search tree
+// and the first node of the frontier.
+// Output:
+//		0 --> The search has been initialized
+//		-1 --> Memory problem when creating the root
+int initialize_search(struct search_context *ctx, int initial_value, int target_value, int method)
+{
+	struct tree_node *root;	// the root of the search tree.
+
+	ctx->method=method;
+	ctx->initial_value=initial_value;
+	ctx->target_value=target_value;
+	ctx->target_landmarks = uses_landmarks(ctx) ?
+		landmarks.costs+2*(size_t) target_value*landmarks.header->count : NULL;
+	ctx->find_children=select_find_children(ctx);
+	ctx->expanded_nodes=0;
+	ctx->budget_countdown=1;
+	ctx->frontier_size=0;
+	ctx->critical_time=0;
+	memset(&ctx->stats, 0, sizeof(struct search_stats));
+	ctx->running=1;
+	ctx->c1=cpu_clock();
+	ctx->t1=wall_clock();
+
+	root=alloc_tree_node(ctx);
+	if (root==NULL)
+		return -1;
+
+	// Initialize search tree
+	root->parent=NULL;
+	root->operation=-1;
+	root->node_value=initial_value;
+	root->g=0;
+	root->node_depth=0;
+	root->next_operation=-1;
+	root->h=heuristic(ctx, root->node_value);
+	if (method==best)
+		root->f=root->h;
+	else if (method==astar)
+		root->f=root->g+root->h;
+	else if (method==idastar || method==hdastar)
+		root->f=f(root->g,root->h,method);
+	else
+		root->f=0;
+	if (ctx->target_landmarks!=NULL)
+	{
+		root->h=landmark_heuristic(ctx, root->node_value);
+		root->f=root->g+root->h;
+	}
+	ctx->root=root;
+
+	if (method==bidirectional)
+		return initialize_bidirectional(ctx, root);
+	if (method==arastar)
+		return initialize_anytime(ctx, root);
+
+	// idastar and iddfs keep only the current path, in ctx->path, the root of hdastar
+	// is given to its owner thread by search_parallel, search_dense, search_levels
+	// and search_compact have their own queue, and the methods of portfolio their own search
+	if (method==idastar || method==iddfs || method==hdastar || method==pbreadth || method==portfolio ||
+		uses_dense(method) || uses_compact(method))
+		return 0;
+
+	// The root is the first value of the closed set
+	if (duplicate_kind!=DUPLICATES_PATH && method!=depth)
+	{
+		struct closed_entry *entry;
+		if (check_with_closed(ctx, root->node_value, root->g, &entry)<0)
+			return -1;
+		record_closed(entry, root);
+	}
+
+	// Initialize frontier
+	if (uses_heap(method))
+		return add_frontier_heap(ctx, root);
+	else if (uses_buckets(method))
+		return add_frontier_bucket(ctx, root);
+	else
+		return add_frontier_front(ctx, root);
+}
+
+// Returns the memory held by the frontier heaps and buckets, the closed sets and the
+// path table of a search, at their current capacity.
+long container_memory(struct search_context *ctx)
+{
+	return (long) (ctx->frontier_heap.capacity+ctx->backward_heap.capacity)*sizeof(struct heap_entry) +
+		(ctx->closed.capacity+ctx->backward_closed.capacity+ctx->expanded.capacity)*sizeof(struct closed_entry) +
+		(long) ctx->inconsistent.capacity*sizeof(struct heap_entry) +
+		(long) ctx->path_capacity*sizeof(struct path_step) +
+		(ctx->frontier_buckets.buckets!=NULL ? BUCKET_WINDOW*sizeof(struct frontier_node*) : 0) +
+		(long) ctx->frontier_buckets.overflow.capacity*sizeof(struct heap_entry) +
+		ctx->queue_capacity*(long) sizeof(struct dense_entry) +
+		ctx->store.capacity*(long) (2*sizeof(int)+sizeof(unsigned int)) +
+		ctx->store.stack_capacity*(long) sizeof(int) +
+		ctx->store.closed.capacity*(long) sizeof(int) +
+		(ctx->visited!=NULL ? BITMAP_WORDS*(long) sizeof(unsigned int) : 0);
+}
+
+// This function stops the clocks of a search, on its first call after initialize_search.
+// It must be called by the thread that has run the search, for its processor time.
+void stop_clocks(struct search_context *ctx)
+{
+	if (ctx->running)
+	{
+		ctx->running=0;
+		ctx->t2=wall_clock();
+		ctx->stats.expanded=ctx->expanded_nodes;
+		ctx->stats.wall_time=ctx->t2-ctx->t1;
+		ctx->stats.cpu_time+=cpu_clock()-ctx->c1;
+	}
+}
+
+// This function ends a search: all the search-tree nodes, the frontier and the
+// closed set are released in one go, and the context can be used for a new search.
+// The solution (if any) is kept.
+void end_search(struct search_context *ctx)
+{
+	while (ctx->tree_chunks!=NULL)
+	{
+		struct tree_chunk *next=ctx->tree_chunks->next;
+		free(ctx->tree_chunks);
+		ctx->tree_chunks=next;
+	}
+	while (ctx->frontier_chunks!=NULL)
+	{
+		struct frontier_chunk *next=ctx->frontier_chunks->next;
+		free(ctx->frontier_chunks);
+		ctx->frontier_chunks=next;
+	}
+	ctx->free_frontier_nodes=NULL;
+	ctx->free_tree_nodes=NULL;
+	ctx->frontier_head=NULL;
+	ctx->frontier_tail=NULL;
+	ctx->frontier_size=0;
+
+	ctx->stats.bytes_allocated+=container_memory(ctx);
+
+	free_heap(&ctx->frontier_heap);
+	free_buckets(&ctx->frontier_buckets);
+	free_closed_set(&ctx->closed);
+	free_heap(&ctx->backward_heap);
+	free_closed_set(&ctx->backward_closed);
+	free_heap(&ctx->inconsistent);
+	free_closed_set(&ctx->expanded);
+	free(ctx->path);
+	ctx->path=NULL;
+	ctx->path_capacity=0;
+	free(ctx->visited);
+	ctx->visited=NULL;
+	free(ctx->queue);
+	ctx->queue=NULL;
+	ctx->queue_capacity=0;
+	free_node_store(&ctx->store);
+	ctx->root=NULL;
+	stop_clocks(ctx);
+}
+
+// Returns the memory used by a search so far: the chunks of the search tree and of the
+// frontier (counted in stats.bytes_allocated when they are allocated) and the containers.
+long search_memory(struct search_context *ctx)
+{
+	return ctx->stats.bytes_allocated+container_memory(ctx);
+}
+
+// This function checks the budgets of a search (--timeout, --max-expanded and --max-memory)
+// before an expansion. The nodes expanded are compared at every call, but the clock and the
+// memory only once every BUDGET_CHECK_INTERVAL calls, as reading them costs more than the
+// expansion of a node, and so is the cancellation of the search by a portfolio.
+// Output:
+//		0 --> The search can go on
+//		STOP_TIME, STOP_NODES or STOP_MEMORY --> The budget that is exhausted, also kept in ctx->stats.stopped
+//		STOP_CANCEL --> The search has been cancelled
+int over_budget(struct search_context *ctx)
+{
+	if (max_expanded>0 && ctx->expanded_nodes>=max_expanded)
+		return ctx->stats.stopped=STOP_NODES;
+	if (--ctx->budget_countdown>0)
+		return 0;
+	ctx->budget_countdown=BUDGET_CHECK_INTERVAL;
+	if (ctx->cancel!=NULL && atomic_load_long(ctx->cancel))
+		return ctx->stats.stopped=STOP_CANCEL;
+	if (wall_clock()-ctx->t1 > time_limit)
+		return ctx->stats.stopped=STOP_TIME;
+	if (max_memory>0 && search_memory(ctx)>max_memory)
+		return ctx->stats.stopped=STOP_MEMORY;
+	return 0;
+}
+
+// This function prints a message of a search, unless the search is quiet: the methods
+// of portfolio run in threads, and only the winner is reported, by search_portfolio.
+void search_message(struct search_context *ctx, const char *format, ...)
+{
+	va_list arguments;
+
+	if (ctx->quiet)
+		return;
+	va_start(arguments, format);
+	vprintf(format, arguments);
+	va_end(arguments);
+}
+
+// This function prints the budget that has stopped a search, if any.
+void print_stop(struct search_context *ctx)
+{
+	if (ctx->stats.stopped==STOP_TIME)
+		search_message(ctx, "Timeout\n");
+	else if (ctx->stats.stopped==STOP_NODES)
+		search_message(ctx, "Node limit reached: %ld nodes expanded\n",ctx->expanded_nodes);
+	else if (ctx->stats.stopped==STOP_MEMORY)
+		search_message(ctx, "Memory limit reached: more than %ld bytes of search memory\n",max_memory);
+}
+
+// Returns the exit status of a search: EXIT_TIME, EXIT_NODES or EXIT_MEMORY if a budget
+// has stopped it, 0 otherwise.
+int exit_status(struct search_stats *stats)
+{
+	if (stats->stopped==STOP_TIME)
+		return EXIT_TIME;
+	if (stats->stopped==STOP_NODES)
+		return EXIT_NODES;
+	if (stats->stopped==STOP_MEMORY)
+		return EXIT_MEMORY;
+	return 0;
+}
+
+// This function prepares an empty search context.
+void init_search_context(struct search_context *ctx)
+{
+	memset(ctx, 0, sizeof(struct search_context));
+}
+
+// This function releases everything held by a search context, including its solution.
+void free_search_context(struct search_context *ctx)
+{
+	end_search(ctx);
+	free(ctx->solution);
+	ctx->solution=NULL;
+	ctx->solution_length=0;
+}
+
+// This function expands the first node of one of the frontiers of the bidirectional search.
+// The forward search generates the children of the node with the six operators, and the
+// backward search generates its predecessors with the inverse operators. Both sides are
+// uniform-cost searches, and a value that is already known by the other side gives a
+// path from the root to the target, which is kept if it is the cheapest so far.
+// Inputs:
+//		int forward	: 1 for the forward frontier, 0 for the backward one
+// Output:
+//		0 --> The node has been expanded
+//		-1 --> Memory problem
+int expand_bidirectional(struct search_context *ctx, int forward)
+{
+	struct node_heap *heap = forward ? &ctx->frontier_heap : &ctx->backward_heap;
+	struct closed_set *closed = forward ? &ctx->closed : &ctx->backward_closed;
+	struct closed_set *other = forward ? &ctx->backward_closed : &ctx->closed;
+	struct tree_node *current_node=heap->entries[0].n, *child, *met;
+	struct closed_entry *entry;
+	struct move moves[MAX_MOVES];
+	int i, count;
+
+	heap_pop(heap);
+	if (lookup_closed(closed, current_node->node_value)!=current_node)
+		return 0;	// A cheaper node with the same value has been found later
+	ctx->expanded_nodes++;
+
+	if (forward)
+		count=successors(current_node->node_value, moves);
+	else
+		count=predecessors(current_node->node_value, moves);
+	for (i=0;i<count;i++)
+	{
+		int g=current_node->g+moves[i].cost;
+
+		if (!cost_fits(current_node->g, moves[i].cost))
+			continue;
+		entry=add_closed(closed, moves[i].node_value);
+		if (entry==NULL)
+			return -1;
+		count_child(ctx, moves[i].operation, entry->n!=NULL && entry->g<=g);
+		if (entry->n!=NULL && entry->g<=g)
+			continue;
+
+		child=alloc_tree_node(ctx);
+		if (child==NULL)
+			return -1;
+		child->node_value=moves[i].node_value;
+		child->operation=moves[i].operation;
+		child->parent=current_node;
+		child->node_depth=current_node->node_depth+1;
+		child->g=g;
+		child->h=0;
+		child->f=g;
+		entry->g=g;
+		entry->n=child;
+		if (heap_push(heap, child)<0)
+			return -1;
+		note_frontier_size(ctx, ctx->frontier_heap.size+ctx->backward_heap.size);
+
+		met=lookup_closed(other, child->node_value);
+		if (met!=NULL && (long) g+met->g<ctx->meeting_cost)
+		{
+			ctx->meeting_cost=(long) g+met->g;
+			ctx->meeting_forward = forward ? child : met;
+			ctx->meeting_backward = forward ? met : child;
+		}
+	}
+	return 0;
+}
+
+// This function joins the two halves of the best path of the bidirectional search:
+// the nodes of the backward half are copied, in reverse order, as descendants of the
+// forward node of the meeting point.
+// Output:
+//		The node of the target at the end of the path, or NULL in case of memory problem.
+struct tree_node *join_bidirectional(struct search_context *ctx)
+{
+	struct tree_node *last=ctx->meeting_forward;
+	struct tree_node *backward_node=ctx->meeting_backward;
+
+	while (backward_node->parent!=NULL)
+	{
+		struct tree_node *child=alloc_tree_node(ctx);
+		if (child==NULL)
+			return NULL;
+		child->node_value=backward_node->parent->node_value;
+		child->operation=backward_node->operation;
+		child->parent=last;
+		child->node_depth=last->node_depth+1;
+		child->g=last->g+(backward_node->g-backward_node->parent->g);
+		child->h=0;
+		child->f=child->g;
+		last=child;
+		backward_node=backward_node->parent;
+	}
+	return last;
+}
+
+// This function implements the bidirectional search. The side with the smaller frontier
+// is expanded first, and the search stops as soon as the cheapest nodes of the two
+// frontiers cannot lead to a path cheaper than the best one found, which is then optimal.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the target at the end of an optimal path.
+struct tree_node *search_bidirectional(struct search_context *ctx)
+{
+	struct tree_node *solution_node;
+
+	while (ctx->frontier_heap.size>0 && ctx->backward_heap.size>0)
+	{
+		if (over_budget(ctx))
+		{
+			print_stop(ctx);
+			return NULL;
+		}
+		if (ctx->meeting_forward!=NULL &&
+			(long) ctx->frontier_heap.entries[0].n->g+ctx->backward_heap.entries[0].n->g>=ctx->meeting_cost)
+			break;
+
+		if (expand_bidirectional(ctx, ctx->frontier_heap.size<=ctx->backward_heap.size)<0)
+		{
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return NULL;
+		}
+	}
+
+	if (ctx->meeting_forward==NULL)
+		return NULL;
+	solution_node=join_bidirectional(ctx);
+	if (solution_node==NULL)
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	return solution_node;
+}
+
+// This function runs an iteration of arastar: the nodes of the frontier are expanded in
+// order of their weighted f, until the cheapest path to the target found so far is not
+// more expensive than the f of the first node. A value that gets a cheaper path after it
+// has been expanded in this iteration is not expanded again, but kept in ctx->inconsistent
+// for the next iteration.
+// Output:
+//		1 --> The iteration is over
+//		0 --> A budget is exhausted
+//		-1 --> Memory problem
+int improve_path(struct search_context *ctx)
+{
+	struct move moves[MAX_MOVES];
+	struct closed_entry *entry;
+	struct tree_node *goal;
+	int i, n, err;
+
+	while (ctx->frontier_heap.size>0)
+	{
+		struct tree_node *current_node=ctx->frontier_heap.entries[0].n;
+
+		// A node is stale if a cheaper node with the same value has been added later
+		if (lookup_closed(&ctx->closed, current_node->node_value)!=current_node)
+		{
+			heap_pop(&ctx->frontier_heap);
+			continue;
+		}
+		goal=lookup_closed(&ctx->closed, ctx->target_value);
+		if (goal!=NULL && goal->g<=current_node->f)
+			return 1;
+		if (over_budget(ctx))
+			return 0;
+
+		heap_pop(&ctx->frontier_heap);
+		entry=add_closed(&ctx->expanded, current_node->node_value);
+		if (entry==NULL)
+			return -1;
+		entry->g=current_node->g;
+		entry->n=current_node;
+		ctx->expanded_nodes++;
+
+		n=successors(current_node->node_value, moves);
+		for (i=0;i<n;i++)
+		{
+			long g=(long) current_node->g+moves[i].cost;
+			struct tree_node *child;
+
+			if (g>INT_MAX || (ctx->target_landmarks!=NULL && moves[i].node_value>landmarks.header->max_value))
+				continue;
+			entry=add_closed(&ctx->closed, moves[i].node_value);
+			if (entry==NULL)
+				return -1;
+			count_child(ctx, moves[i].operation, entry->n!=NULL && entry->g<=g);
+			if (entry->n!=NULL && entry->g<=g)
+				continue;
+
+			child=alloc_tree_node(ctx);
+			if (child==NULL)
+				return -1;
+			child->parent=current_node;
+			child->operation=moves[i].operation;
+			child->node_value=moves[i].node_value;
+			child->node_depth=current_node->node_depth+1;
+			child->g=(int) g;
+			child->h = entry->n!=NULL ? entry->n->h : admissible_heuristic(ctx, child->node_value);
+			child->f=weighted_f(ctx, child);
+			entry->g=child->g;
+			entry->n=child;
+
+			if (lookup_closed(&ctx->expanded, child->node_value)!=NULL)
+				err=heap_push(&ctx->inconsistent, child);
+			else
+				err=add_frontier_heap(ctx, child);
+			if (err<0)
+				return -1;
+		}
+	}
+	return 1;
+}
+
+// This function computes the suboptimality bound of a solution of arastar: its cost over
+// the smallest g+h of the nodes that may still lead to a cheaper path, those of the
+// frontier and the inconsistent ones. Since h is admissible, the optimum is not lower
+// than that. The bound is never more than the weight, nor less than 1.
+double suboptimality_bound(struct search_context *ctx, struct tree_node *goal)
+{
+	struct node_heap *heaps[2]={&ctx->frontier_heap, &ctx->inconsistent};
+	long lowest=goal->g;
+	double bound;
+	int i, j;
+
+	for (i=0;i<2;i++)
+		for (j=0;j<heaps[i]->size;j++)
+		{
+			struct tree_node *node=heaps[i]->entries[j].n;
+			if (lookup_closed(&ctx->closed, node->node_value)==node && (long) node->g+node->h<lowest)
+				lowest=(long) node->g+node->h;
+		}
+	if (lowest<=0)
+		return goal->g>0 ? ctx->weight : 1;
+	bound=(double) goal->g/lowest;
+	if (bound>ctx->weight)
+		bound=ctx->weight;
+	return bound<1 ? 1 : bound;
+}
+
+// This function starts a new iteration of arastar with a lower weight. The nodes of the
+// frontier and the inconsistent ones are put back into the frontier with their new f,
+// and no value has been expanded by the new iteration yet.
+// Output:
+//		0 --> The new iteration can start
+//		-1 --> Memory problem
+int lower_weight(struct search_context *ctx)
+{
+	struct node_heap old=ctx->frontier_heap;
+	struct node_heap *heaps[2]={&old, &ctx->inconsistent};
+	int i, j, err=0;
+
+	ctx->weight = ctx->weight-ARA_WEIGHT_STEP>1 ? ctx->weight-ARA_WEIGHT_STEP : 1;
+	memset(&ctx->frontier_heap, 0, sizeof(struct node_heap));
+	for (i=0;i<2 && err==0;i++)
+		for (j=0;j<heaps[i]->size && err==0;j++)
+		{
+			struct tree_node *node=heaps[i]->entries[j].n;
+			if (lookup_closed(&ctx->closed, node->node_value)!=node)
+				continue;
+			node->f=weighted_f(ctx, node);
+			err=add_frontier_heap(ctx, node);
+		}
+	free_heap(&old);
+	ctx->inconsistent.size=0;
+	free_closed_set(&ctx->expanded);
+	return err;
+}
+
+// This function implements arastar, an anytime weighted astar (ARA*). The first iteration
+// uses f=g+w*h with the weight w of --weight and an admissible h, and finds a solution
+// fast, at most w times more expensive than the optimum. Every next iteration lowers the
+// weight by ARA_WEIGHT_STEP, and improves the solution with the nodes of the previous one,
+// until the weight is 1 and the solution is optimal. When the time limit is reached, the
+// best solution so far is returned, with its bound in ctx->suboptimality.
+// Output:
+//		NULL --> The problem cannot be solved, or no solution has been found in time
+//		struct tree_node*	: The node of the target at the end of the best path found.
+struct tree_node *search_anytime(struct search_context *ctx)
+{
+	struct tree_node *goal;
+	int err;
+
+	while (1)
+	{
+		err=improve_path(ctx);
+		goal=lookup_closed(&ctx->closed, ctx->target_value);
+		if (err<0)
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		else if (err==0)
+			print_stop(ctx);
+		if (goal==NULL)
+			return NULL;
+
+		ctx->suboptimality=suboptimality_bound(ctx, goal);
+		if (err<=0)
+		{
+			search_message(ctx, "Best solution: cost %d, at most %.3f times the optimum\n",goal->g,ctx->suboptimality);
+			return goal;
+		}
+		search_message(ctx, "Weight %.2f: cost %d after %f secs, at most %.3f times the optimum\n",
+			ctx->weight,goal->g,wall_clock()-ctx->t1,ctx->suboptimality);
+		if (ctx->suboptimality<=1)
+			return goal;
+		if (lower_weight(ctx)<0)
+		{
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return goal;
+		}
+	}
+}
+
+// This function adds a value at the end of the current path, growing the path table
+// if needed, and generates its moves.
+// Output:
+//		0 --> The value has been added
+//		-1 --> Memory problem
+int push_path_step(struct search_context *ctx, int length, int node_value, int g, int operation)
+{
+	struct path_step *step;
+
+	if (length==ctx->path_capacity)
+	{
+		int capacity = ctx->path_capacity>0 ? 2*ctx->path_capacity : 64;
+		struct path_step *path=realloc(ctx->path, capacity*sizeof(struct path_step));
+		if (path==NULL)
+			return -1;
+		ctx->path=path;
+		ctx->path_capacity=capacity;
+	}
+	step=&ctx->path[length];
+	step->node_value=node_value;
+	step->g=g;
+	step->operation=operation;
+	step->next_move=0;
+	step->move_count=successors(node_value, step->moves);
+	note_frontier_size(ctx, length+1);
+	return 0;
+}
+
+// Returns 1 if a value is one of the first length values of the current path.
+int on_path(struct search_context *ctx, int length, int node_value)
+{
+	int i;
+
+	for (i=0;i<length;i++)
+		if (ctx->path[i].node_value==node_value)
+			return 1;
+	return 0;
+}
+
+// This function runs one iteration of idastar or iddfs: a depth-first search from the
+// root that only keeps the current path, and cuts off every value whose f (idastar) or
+// depth (iddfs) exceeds the bound. Values that are already on the path are skipped.
+// Inputs:
+//		long bound		: The bound of the iteration
+//		long *next_bound	: Set to the smallest f or depth that has been cut off
+// Output:
+//		>0 --> The length of the path to the target, stored in ctx->path
+//		0 --> The target is not reachable within the bound
+//		-1 --> Memory problem
+//		-2 --> A budget is exhausted
+int bounded_search(struct search_context *ctx, long bound, long *next_bound)
+{
+	int method=ctx->method;
+	int length=0;
+
+	if (push_path_step(ctx, length++, ctx->initial_value, 0, -1)<0)
+		return -1;
+	ctx->expanded_nodes++;
+
+	while (length>0)
+	{
+		struct path_step *step=&ctx->path[length-1];
+		struct move move;
+		int repeated;
+		long g, cost;
+
+		if (step->next_move==step->move_count)
+		{
+			length--;	// Backtracking
+			continue;
+		}
+		move=step->moves[step->next_move++];	// A copy, as the path may be moved by push_path_step
+		g=(long) step->g+move.cost;
+		if (g>INT_MAX)
+			continue;
+		repeated=on_path(ctx, length, move.node_value);
+		count_child(ctx, move.operation, repeated);
+		if (repeated)
+			continue;
+
+		if (method==idastar)
+			cost=f(g,heuristic(ctx, move.node_value),method);
+		else
+			cost=length;
+		if (cost>bound)
+		{
+			if (cost<*next_bound)
+				*next_bound=cost;
+			continue;
+		}
+
+		if (push_path_step(ctx, length++, move.node_value, g, move.operation)<0)
+			return -1;
+		if (is_solution(ctx, move.node_value))
+			return length;
+
+		if (over_budget(ctx))
+			return -2;
+		ctx->expanded_nodes++;
+	}
+	return 0;
+}
+
+// This function implements idastar and iddfs: depth-first iterations with a bound on f
+// (idastar) or on the depth (iddfs) that grows to the smallest value cut off by the
+// previous iteration. The memory needed is proportional to the depth of the search.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *search_iterative(struct search_context *ctx)
+{
+	struct tree_node *last=ctx->root;
+	long bound=ctx->root->f, next_bound;
+	int i, length;
+
+	if (is_solution(ctx, ctx->initial_value))
+		return ctx->root;
+
+	do
+	{
+		next_bound=LONG_MAX;
+		length=bounded_search(ctx, bound, &next_bound);
+		bound=next_bound;
+	} while (length==0 && next_bound<LONG_MAX);
+
+	if (length==-2)
+		print_stop(ctx);
+	if (length==-1)
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	if (length<=0)
+		return NULL;
+
+	// The path becomes a branch of the search tree
+	for (i=1;i<length;i++)
+	{
+		struct tree_node *child=alloc_tree_node(ctx);
+		if (child==NULL)
+		{
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return NULL;
+		}
+		child->parent=last;
+		child->operation=ctx->path[i].operation;
+		child->node_value=ctx->path[i].node_value;
+		child->node_depth=i;
+		child->g=ctx->path[i].g;
+		child->h=heuristic(ctx, child->node_value);
+		child->f=f(child->g,child->h,ctx->method);
+		last=child;
+	}
+	return last;
+}
+
+// This function marks a value in a bitmap of all the values. The bit is set atomically,
+// so that several threads can share the bitmap.
+// Output:
+//		1 --> The value was already marked
+//		0 --> The value has been marked now
+int mark_value(unsigned int *bitmap, int node_value)
+{
+	unsigned int bit=1u<<(node_value&31);
+
+	if (((volatile unsigned int *) bitmap)[node_value>>5] & bit)
+		return 1;
+	return (atomic_or_int(&bitmap[node_value>>5], bit) & bit)!=0;
+}
+
+// This function adds a value at the end of the queue of search_dense, growing the queue
+// table if it is full.
+// Output:
+//		0 --> The value has been added
+//		-1 --> Memory problem
+int push_dense(struct search_context *ctx, long *length, int node_value, int g, int parent)
+{
+	if (*length==ctx->queue_capacity)
+	{
+		long new_capacity = ctx->queue_capacity==0 ? DENSE_QUEUE : 2*ctx->queue_capacity;
+		struct dense_entry *new_queue=(struct dense_entry*) realloc(ctx->queue, new_capacity*sizeof(struct dense_entry));
+		if (new_queue==NULL)
+			return -1;
+		ctx->queue=new_queue;
+		ctx->queue_capacity=new_capacity;
+	}
+	ctx->queue[*length].node_value=node_value;
+	ctx->queue[*length].g=g;
+	ctx->queue[*length].parent=parent;
+	(*length)++;
+	return 0;
+}
+
+// This function rebuilds the path to an entry of the queue of search_dense as a branch of
+// the search tree. The operation of each move is the first one, in the order of the
+// children, that leads to the next value, as it is the one that has reached it first.
+// Output:
+//		NULL --> Memory problem
+//		struct tree_node*	: The node of the entry at the end of the path.
+struct tree_node *dense_path(struct search_context *ctx, int index)
+{
+	struct move moves[MAX_MOVES];
+	struct tree_node *last=ctx->root;
+	int *path, length=0, i, j;
+
+	for (i=index; ctx->queue[i].parent>=0; i=ctx->queue[i].parent)
+		length++;
+	path=(int*) malloc((length>0 ? length : 1)*sizeof(int));
+	if (path==NULL)
+		return NULL;
+	for (i=index, j=length; ctx->queue[i].parent>=0; i=ctx->queue[i].parent)
+		path[--j]=i;
+
+	for (i=0;i<length;i++)
+	{
+		struct tree_node *child=alloc_tree_node(ctx);
+		int node_value=ctx->queue[path[i]].node_value;
+
+		if (child==NULL)
+		{
+			free(path);
+			return NULL;
+		}
+		successors(last->node_value, moves);
+		for (j=0; moves[j].node_value!=node_value; j++)
+			;
+		child->parent=last;
+		child->operation=moves[j].operation;
+		child->node_value=node_value;
+		child->node_depth=i+1;
+		child->g=last->g+moves[j].cost;
+		child->h=heuristic(ctx, node_value);
+		child->f=0;
+		last=child;
+	}
+	free(path);
+	return last;
+}
+
+// This function implements breadth with --duplicates bitmap, for searches over a large part
+// of the values: the values reached are marked in a bitmap of all the values (125 MB,
+// whose pages are only allocated when they are touched) instead of the closed set, and
+// the queue is an array of (value, cost, parent index) entries, 12 bytes per value, instead of the
+// search tree and the frontier list. The children are generated in the same order as
+// breadth, so the solution is the same.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *search_dense(struct search_context *ctx)
+{
+	struct move moves[MAX_MOVES];
+	struct tree_node *solution_node;
+	long head, length=0;
+	int i, n;
+
+	ctx->visited=(unsigned int*) calloc(BITMAP_WORDS, sizeof(unsigned int));
+	if (ctx->visited==NULL || push_dense(ctx, &length, ctx->initial_value, 0, -1)<0)
+	{
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		return NULL;
+	}
+	mark_value(ctx->visited, ctx->initial_value);
+	if (is_solution(ctx, ctx->initial_value))
+		return ctx->root;
+
+	for (head=0; head<length; head++)
+	{
+		if (over_budget(ctx))
+		{
+			print_stop(ctx);
+			return NULL;
+		}
+		ctx->expanded_nodes++;
+		n=successors(ctx->queue[head].node_value, moves);
+		for (i=0;i<n;i++)
+		{
+			int repeated;
+
+			if (!cost_fits(ctx->queue[head].g, moves[i].cost))
+				continue;
+			repeated=mark_value(ctx->visited, moves[i].node_value);
+			count_child(ctx, moves[i].operation, repeated);
+			if (repeated)
+				continue;
+			if (push_dense(ctx, &length, moves[i].node_value, ctx->queue[head].g+moves[i].cost, (int) head)<0)
+			{
+				search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+				return NULL;
+			}
+			if (is_solution(ctx, moves[i].node_value))
+			{
+				note_frontier_size(ctx, length-head-1);
+				solution_node=dense_path(ctx, (int) length-1);
+				if (solution_node==NULL)
+					search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+				return solution_node;
+			}
+		}
+		note_frontier_size(ctx, length-head-1);
+	}
+	return NULL;
+}
+
+// This function adds a node at the end of a compact node store, growing its arrays if they
+// are full. The root is its own parent.
+// Output:
+//		>=0 --> The index of the new node
+//		-1 --> Memory problem, or more nodes than the links can index
+long add_compact_node(struct node_store *store, int node_value, int g, long parent, int operation)
+{
+	if (store->count==store->capacity)
+	{
+		long new_capacity = store->capacity==0 ? COMPACT_NODES : 2*store->capacity;
+		int *values, *costs;
+		unsigned int *links;
+
+		if (store->count>=COMPACT_MAX_NODES)
+			return -1;
+		values=(int*) realloc(store->values, new_capacity*sizeof(int));
+		if (values==NULL)
+			return -1;
+		store->values=values;
+		costs=(int*) realloc(store->g, new_capacity*sizeof(int));
+		if (costs==NULL)
+			return -1;
+		store->g=costs;
+		links=(unsigned int*) realloc(store->links, new_capacity*sizeof(unsigned int));
+		if (links==NULL)
+			return -1;
+		store->links=links;
+		store->capacity=new_capacity;
+	}
+	store->values[store->count]=node_value;
+	store->g[store->count]=g;
+	store->links[store->count]=(unsigned int) parent | (unsigned int) operation<<LINK_SHIFT;
+	return store->count++;
+}
+
+// This function pushes the operators left to a new node of the branch of depth.
+// Output:
+//		0 --> The entry has been pushed
+//		-1 --> Memory problem
+int push_compact(struct node_store *store, int operations_left)
+{
+	if (store->stack_size==store->stack_capacity)
+	{
+		long new_capacity = store->stack_capacity==0 ? COMPACT_NODES : 2*store->stack_capacity;
+		int *stack=(int*) realloc(store->stack, new_capacity*sizeof(int));
+		if (stack==NULL)
+			return -1;
+		store->stack=stack;
+		store->stack_capacity=new_capacity;
+	}
+	store->stack[store->stack_size++]=operations_left;
+	return 0;
+}
+
+// This function is check_with_parents for the compact node store: it walks from a node
+// up to the root, over the values and links arrays only.
+// Output:
+//		1 --> node_value is not the value of the node or of one of its ancestors
+//		0 --> Loop detection
+int compact_off_path(struct node_store *store, long index, int node_value)
+{
+	while (store->values[index]!=node_value)
+	{
+		if (index==0)
+			return 1;
+		index=store->links[index] & LINK_PARENT;
+	}
+	return 0;
+}
+
+// This function rebuilds the path to a node of the compact node store as a branch of the
+// search tree, with the depth and h of its nodes, so that extract_solution can use it.
+// Output:
+//		NULL --> Memory problem
+//		struct tree_node*	: The node at the end of the path.
+struct tree_node *compact_path(struct search_context *ctx, long index)
+{
+	struct node_store *store=&ctx->store;
+	struct tree_node *last=ctx->root;
+	long *path, i, j;
+	int length=0;
+
+	for (i=index; i!=0; i=store->links[i] & LINK_PARENT)
+		length++;
+	path=(long*) malloc((length>0 ? length : 1)*sizeof(long));
+	if (path==NULL)
+		return NULL;
+	for (i=index, j=length; i!=0; i=store->links[i] & LINK_PARENT)
+		path[--j]=i;
+
+	for (j=0;j<length;j++)
+	{
+		struct tree_node *child=alloc_tree_node(ctx);
+
+		if (child==NULL)
+		{
+			free(path);
+			return NULL;
+		}
+		child->parent=last;
+		child->operation=(int) (store->links[path[j]]>>LINK_SHIFT);
+		child->node_value=store->values[path[j]];
+		child->node_depth=(int) j+1;
+		child->g=store->g[path[j]];
+		child->h=heuristic(ctx, child->node_value);
+		child->f=0;
+		last=child;
+	}
+	free(path);
+	return last;
+}
+
+// This function implements depth with --nodes compact, as search_depth does with the
+// search tree: the children of a node are generated one at a time, and a node is dropped
+// when it has no child left, so the store only holds the current branch. It is always
+// the last node of the store. The closed set holds the values expanded, and with
+// --duplicates path the values on the way to the root are checked instead.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the solution at the end of its path.
+struct tree_node *search_compact_depth(struct search_context *ctx)
+{
+	struct node_store *store=&ctx->store;
+	struct tree_node *solution_node;
+	struct move move;
+	int closed=duplicate_kind!=DUPLICATES_PATH;
+	long current;
+	int err;
+
+	if (add_compact_node(store, ctx->initial_value, 0, 0, 0)<0 || push_compact(store, -1)<0)
+	{
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		return NULL;
+	}
+	note_frontier_size(ctx, 1);
+
+	while (store->count>0)
+	{
+		current=store->count-1;
+		if (store->stack[current]<0)
+		{
+			// A new node at the end of the branch
+			if (over_budget(ctx))
+			{
+				print_stop(ctx);
+				return NULL;
+			}
+			if (is_solution(ctx, store->values[current]))
+			{
+				solution_node = current==0 ? ctx->root : compact_path(ctx, current);
+				if (solution_node==NULL)
+					search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+				return solution_node;
+			}
+
+			// Already expanded values are skipped
+			err = closed ? add_value(&store->closed, store->values[current]) : 1;
+			if (err<0)
+			{
+				search_message(ctx, "Memory exhausted while growing the closed set. Search is terminated...\n");
+				return NULL;
+			}
+			if (err>0)
+			{
+				ctx->expanded_nodes++;
+				store->stack[current]=OPERATOR_COUNT;
+			}
+		}
+
+		// The next child, in the order of find_next_child_depth
+		err=0;
+		while (err==0 && store->stack[current]>0)
+		{
+			if (!successor(store->values[current], operator_order[--store->stack[current]], &move) ||
+				!cost_fits(store->g[current], move.cost))
+				continue;
+			err = closed ? !has_value(&store->closed, move.node_value) : compact_off_path(store, current, move.node_value);
+			count_child(ctx, move.operation, err==0);
+		}
+		if (err>0)
+		{
+			if (add_compact_node(store, move.node_value, store->g[current]+move.cost, current, move.operation)<0 ||
+				push_compact(store, -1)<0)
+			{
+				search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+				return NULL;
+			}
+			note_frontier_size(ctx, store->count);
+			continue;
+		}
+
+		// A node that has been skipped, or has no child left, leaves the branch
+		store->count--;
+		store->stack_size--;
+	}
+	return NULL;
+}
+
+// This function implements breadth with --nodes compact. It expands the same nodes in the
+// same order as search_method does with the search tree and the frontier list, with the
+// same detection of repeated values: the closed set holds every value generated, and with
+// --duplicates path the values on the way to the root are checked instead.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the solution at the end of its path.
+struct tree_node *search_compact(struct search_context *ctx)
+{
+	struct node_store *store=&ctx->store;
+	struct move moves[MAX_MOVES];
+	struct tree_node *solution_node;
+	int closed=duplicate_kind!=DUPLICATES_PATH;
+	long current, child;
+	int i, n, err;
+
+	if (ctx->method==depth)
+		return search_compact_depth(ctx);
+	if (add_compact_node(store, ctx->initial_value, 0, 0, 0)<0 ||
+		(closed ? add_value(&store->closed, ctx->initial_value) : 0)<0)
+	{
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		return NULL;
+	}
+	note_frontier_size(ctx, 1);
+
+	while (store->head<store->count)
+	{
+		if (over_budget(ctx))
+		{
+			print_stop(ctx);
+			return NULL;
+		}
+
+		// Extract the first node from the frontier
+		current=store->head++;
+		if (is_solution(ctx, store->values[current]))
+		{
+			solution_node = current==0 ? ctx->root : compact_path(ctx, current);
+			if (solution_node==NULL)
+				search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return solution_node;
+		}
+		ctx->expanded_nodes++;
+
+		n=successors(store->values[current], moves);
+		for (i=0;i<n;i++)
+		{
+			if (!cost_fits(store->g[current], moves[i].cost))
+				continue;
+			if (!closed)
+				err=compact_off_path(store, current, moves[i].node_value);
+			else
+				err=add_value(&store->closed, moves[i].node_value);
+			if (err<0)
+			{
+				search_message(ctx, "Memory exhausted while growing the closed set. Search is terminated...\n");
+				return NULL;
+			}
+			count_child(ctx, moves[i].operation, err==0);
+			if (err==0)
+				continue;
+			child=add_compact_node(store, moves[i].node_value, store->g[current]+moves[i].cost, current, moves[i].operation);
+			if (child<0)
+			{
+				search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+				return NULL;
+			}
+		}
+		note_frontier_size(ctx, store->count-store->head);
+	}
+	return NULL;
+}
+
+struct level_search;
+
+// A thread of pbreadth. In each level it expands its part of the level, and then keeps
+// the first child of each value it owns (see level_owner).
+struct level_worker
+{
+	struct level_search *search;
+	int index;
+	thread_t thread;
+	struct dense_entry *children;	// The children of its part of the level that are not in the previous levels
+	long count;			// Number of children
+	long capacity;			// The size of the children table
+	int **owned;			// For each thread, the indices in children of the values it owns
+	long *owned_count;
+	long *owned_capacity;
+	long *kept_from;		// For each thread, the number of its children kept among the values this thread owns
+	long offset;			// The index in the queue of its first kept child
+	double phase_time;		// Processor time spent in the current phase (see critical_time)
+	struct search_stats stats;	// Its counters: generated, duplicates, operations, memory and processor time
+	int failed;			// 1 in case of memory problem
+};
+
+// The shared state of pbreadth. The queue of the context holds the levels one after the
+// other, as in search_dense, and the threads meet at the barrier between the phases of
+// each level.
+struct level_search
+{
+	struct search_context *ctx;
+	struct level_worker *workers;
+	int count;			// Number of threads
+	int ready;			// 1 when count is known (protected by the lock of the barrier)
+	struct barrier barrier;
+	long first;			// The current level: the entries from first to last-1 of the queue
+	long last;
+	long length;			// The end of the next level in the queue
+	long found;			// The index of the target in the queue, -1 until it is reached
+	int done;			// 1 when the search is over
+	int failed;			// 1 in case of memory problem
+	double critical_time;		// The processor time of the slowest thread of each phase and of the work at
+					// the barriers, summed over the levels: the time with a processor per thread
+};
+
+// Returns the thread of pbreadth that keeps the children with a value. The values of a
+// word of the bitmap belong to the same thread.
+int level_owner(struct level_search *search, int node_value)
+{
+	return (int) (((unsigned int) node_value>>5) % (unsigned int) search->count);
+}
+
+// This function adds a child to the children of a thread of pbreadth, and its index to
+// the children owned by the thread of its value.
+// Output:
+//		0 --> The child has been added
+//		-1 --> Memory problem
+int add_level_child(struct level_worker *worker, int node_value, int g, int parent)
+{
+	int owner=level_owner(worker->search, node_value);
+
+	if (worker->count==worker->capacity)
+	{
+		long new_capacity = worker->capacity==0 ? DENSE_QUEUE : 2*worker->capacity;
+		struct dense_entry *new_children=(struct dense_entry*) realloc(worker->children, new_capacity*sizeof(struct dense_entry));
+		if (new_children==NULL)
+			return -1;
+		worker->children=new_children;
+		worker->capacity=new_capacity;
+	}
+	if (worker->owned_count[owner]==worker->owned_capacity[owner])
+	{
+		long new_capacity = worker->owned_capacity[owner]==0 ? DENSE_QUEUE : 2*worker->owned_capacity[owner];
+		int *new_owned=(int*) realloc(worker->owned[owner], new_capacity*sizeof(int));
+		if (new_owned==NULL)
+			return -1;
+		worker->owned[owner]=new_owned;
+		worker->owned_capacity[owner]=new_capacity;
+	}
+	worker->owned[owner][worker->owned_count[owner]++]=(int) worker->count;
+	worker->children[worker->count].node_value=node_value;
+	worker->children[worker->count].g=g;
+	worker->children[worker->count].parent=parent;
+	worker->count++;
+	return 0;
+}
+
+// This function adds the processor time of the slowest thread of pbreadth in the phase
+// that has just ended to the critical time. It runs in one thread, at a barrier.
+void end_level_phase(void *argument)
+{
+	struct level_search *search=(struct level_search*) argument;
+	double slowest=0;
+	int t;
+
+	for (t=0;t<search->count;t++)
+		if (search->workers[t].phase_time>slowest)
+			slowest=search->workers[t].phase_time;
+	search->critical_time+=slowest;
+}
+
+// This function gives each thread of pbreadth the place of its kept children in the next
+// level, and grows the queue for them. It runs in one thread, at the barrier after the
+// children have been kept by the owners of their values.
+void place_level(void *argument)
+{
+	struct level_search *search=(struct level_search*) argument;
+	struct search_context *ctx=search->ctx;
+	double c1=cpu_clock();
+	long length=search->last;
+	int t, o;
+
+	end_level_phase(search);
+	for (t=0;t<search->count;t++)
+	{
+		if (search->workers[t].failed)
+			search->failed=1;
+		search->workers[t].offset=length;
+		for (o=0;o<search->count;o++)
+			length+=search->workers[o].kept_from[t];
+	}
+	if (!search->failed && length>ctx->queue_capacity)
+	{
+		long new_capacity = 2*ctx->queue_capacity>length ? 2*ctx->queue_capacity : length;
+		struct dense_entry *new_queue=(struct dense_entry*) realloc(ctx->queue, new_capacity*sizeof(struct dense_entry));
+		if (new_queue==NULL)
+			search->failed=1;
+		else
+		{
+			ctx->queue=new_queue;
+			ctx->queue_capacity=new_capacity;
+		}
+	}
+	search->length=length;
+	search->critical_time+=cpu_clock()-c1;
+}
+
+// This function moves pbreadth to the next level, or ends it when the target has been
+// reached, the next level is empty or a budget is exhausted. It runs in one thread, at
+// the barrier after the kept children have been copied to the queue.
+void next_level(void *argument)
+{
+	struct level_search *search=(struct level_search*) argument;
+	struct search_context *ctx=search->ctx;
+	double c1=cpu_clock();
+
+	end_level_phase(search);
+	ctx->expanded_nodes+=search->last-search->first;
+	note_frontier_size(ctx, search->last-search->first);
+	search->first=search->last;
+	search->last=search->length;
+	ctx->budget_countdown=1;		// The budgets are checked once per level
+	search->done = search->failed || search->found>=0 || search->first==search->last || over_budget(ctx);
+	search->critical_time+=cpu_clock()-c1;
+}
+
+// The main function of a thread of pbreadth. Each level is processed in three phases,
+// separated by the barrier, and the work that needs all the threads is done at the
+// barrier by the last thread to arrive:
+// 1. The thread expands its part of the level. The children whose values are in the
+//    bitmap (the previous levels) are rejected, and the others are kept in its children.
+// 2. For each value it owns, the thread keeps the first child in the order of breadth
+//    (the threads in turn, the children of each thread in order), marks it in the bitmap,
+//    and counts the children it keeps for each thread. At the barrier, place_level
+//    places the kept children of each thread in the queue.
+// 3. The thread copies its kept children to the queue. At the barrier, next_level moves
+//    to the next level.
+void level_worker_main(void *argument)
+{
+	struct level_worker *worker=(struct level_worker*) argument;
+	struct level_search *search=worker->search;
+	struct search_context *ctx=search->ctx;
+	struct move moves[MAX_MOVES];
+	double c1=cpu_clock(), c2;
+	long i, k;
+	int j, n, t;
+
+	mutex_lock(&search->barrier.lock);
+	while (!search->ready)
+		cond_wait(&search->barrier.all_arrived, &search->barrier.lock);
+	mutex_unlock(&search->barrier.lock);
+
+	while (1)
+	{
+		long size=search->last-search->first;
+		long to=search->first+size*(worker->index+1)/search->count;
+
+		c2=cpu_clock();
+		worker->count=0;
+		for (t=0;t<search->count;t++)
+			worker->owned_count[t]=0;
+		for (i=search->first+size*worker->index/search->count; i<to && !worker->failed; i++)
+		{
+			n=successors(ctx->queue[i].node_value, moves);
+			for (j=0;j<n;j++)
+			{
+				int node_value=moves[j].node_value;
+
+				if (!cost_fits(ctx->queue[i].g, moves[j].cost))
+					continue;
+				worker->stats.generated++;
+				worker->stats.operations[moves[j].operation]++;
+				if ((ctx->visited[node_value>>5]>>(node_value&31))&1)
+					worker->stats.duplicates++;
+				else if (add_level_child(worker, node_value, ctx->queue[i].g+moves[j].cost, (int) i)<0)
+					worker->failed=1;
+			}
+		}
+		worker->phase_time=cpu_clock()-c2;
+		barrier_wait(&search->barrier, end_level_phase, search);
+
+		c2=cpu_clock();
+		for (t=0;t<search->count;t++)
+		{
+			struct level_worker *other=&search->workers[t];
+
+			worker->kept_from[t]=0;
+			for (k=0;k<other->owned_count[worker->index];k++)
+			{
+				struct dense_entry *child=&other->children[other->owned[worker->index][k]];
+				if (mark_value(ctx->visited, child->node_value))
+					child->parent=-1;	// An earlier child has the same value
+				else
+					worker->kept_from[t]++;
+			}
+		}
+		worker->phase_time=cpu_clock()-c2;
+		barrier_wait(&search->barrier, place_level, search);
+
+		c2=cpu_clock();
+		if (!search->failed)
+		{
+			for (i=worker->offset, k=0; k<worker->count; k++)
+				if (worker->children[k].parent>=0)
+				{
+					if (is_solution(ctx, worker->children[k].node_value))
+						search->found=i;
+					ctx->queue[i++]=worker->children[k];
+				}
+			worker->stats.duplicates+=worker->count-(i-worker->offset);
+		}
+		worker->phase_time=cpu_clock()-c2;
+		barrier_wait(&search->barrier, next_level, search);
+		if (search->done)
+			break;
+	}
+	worker->stats.cpu_time+=cpu_clock()-c1;
+}
+
+// This function implements pbreadth, a level-synchronous parallel breadth with
+// --search-threads threads. The levels are kept in a queue of (value, cost, parent index)
+// entries, and the values reached in a bitmap, as in search_dense. The first child of each
+// value in the order of breadth is kept, so the solution is the same as the one of breadth.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *search_levels(struct search_context *ctx)
+{
+	struct level_search search;
+	struct tree_node *solution_node=NULL;
+	int i, started=0, count = search_threads>0 ? search_threads : cpu_count();
+	long length=0;
+
+	if (is_solution(ctx, ctx->initial_value))
+		return ctx->root;
+	memset(&search, 0, sizeof(search));
+	search.ctx=ctx;
+	search.found=-1;
+	ctx->visited=(unsigned int*) calloc(BITMAP_WORDS, sizeof(unsigned int));
+	search.workers=(struct level_worker*) calloc(count, sizeof(struct level_worker));
+	if (ctx->visited==NULL || search.workers==NULL || push_dense(ctx, &length, ctx->initial_value, 0, -1)<0)
+	{
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		free(search.workers);
+		return NULL;
+	}
+	mark_value(ctx->visited, ctx->initial_value);
+	search.last=search.length=length;
+	for (i=0;i<count;i++)
+	{
+		struct level_worker *worker=&search.workers[i];
+		worker->search=&search;
+		worker->index=i;
+		worker->owned=(int**) calloc(count, sizeof(int*));
+		worker->owned_count=(long*) calloc(count, sizeof(long));
+		worker->owned_capacity=(long*) calloc(count, sizeof(long));
+		worker->kept_from=(long*) calloc(count, sizeof(long));
+		if (worker->owned==NULL || worker->owned_count==NULL || worker->owned_capacity==NULL || worker->kept_from==NULL)
+			search.failed=1;
+	}
+
+	barrier_init(&search.barrier, count);
+	if (!search.failed)
+		for (started=0; started<count; started++)
+			if (thread_create(&search.workers[started].thread, level_worker_main, &search.workers[started])<0)
+				break;
+	// The threads that have been started share the levels
+	mutex_lock(&search.barrier.lock);
+	search.count = started>0 ? started : 1;
+	search.barrier.count=search.count;
+	search.ready=1;
+	cond_broadcast(&search.barrier.all_arrived);
+	mutex_unlock(&search.barrier.lock);
+	if (started==0 && !search.failed)
+		level_worker_main(&search.workers[0]);	// No thread could be started, the search runs here
+	for (i=0;i<started;i++)
+		thread_join(search.workers[i].thread);
+
+	if (search.failed)
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	else
+		print_stop(ctx);
+	if (!search.failed && search.found>=0)
+	{
+		solution_node=dense_path(ctx, (int) search.found);
+		if (solution_node==NULL)
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	}
+
+	for (i=0;i<count;i++)
+	{
+		struct level_worker *worker=&search.workers[i];
+		int t;
+
+		worker->stats.bytes_allocated+=worker->capacity*(long) sizeof(struct dense_entry);
+		for (t=0; t<count && worker->owned!=NULL; t++)
+		{
+			worker->stats.bytes_allocated+=worker->owned_capacity[t]*(long) sizeof(int);
+			free(worker->owned[t]);
+		}
+		add_stats(&ctx->stats, &worker->stats);
+		free(worker->children);
+		free(worker->owned);
+		free(worker->owned_count);
+		free(worker->owned_capacity);
+		free(worker->kept_from);
+	}
+	ctx->critical_time=search.critical_time;
+	free(search.workers);
+	barrier_destroy(&search.barrier);
+	return solution_node;
+}
+
+// The size of a table file with values from 0 to max_value.
+size_t table_size(int max_value)
+{
+	size_t count=(size_t) max_value+1;
+	return sizeof(struct table_header)+count*sizeof(unsigned int)+(count+1)/2;
+}
+
+// Returns the operation stored for a value in a table of operations (0 if there is none).
+int table_operation(unsigned char *operations, int node_value)
+{
+	return (operations[node_value/2]>>(4*(node_value%2))) & 15;
+}
+
+// A binary heap of (cost, value) pairs, used by precompute_table. Each pair is kept
+// in a single key, with the cost in the upper 32 bits.
+struct key_heap
+{
+	unsigned long long *keys;
+	size_t size;
+	size_t capacity;
+};
+
+int key_heap_push(struct key_heap *heap, unsigned long long key)
+{
+	size_t i;
+
+	if (heap->size==heap->capacity)
+	{
+		size_t capacity = heap->capacity>0 ? 2*heap->capacity : 1024;
+		unsigned long long *keys=realloc(heap->keys, capacity*sizeof(unsigned long long));
+		if (keys==NULL)
+			return -1;
+		heap->keys=keys;
+		heap->capacity=capacity;
+	}
+	for (i=heap->size++; i>0 && heap->keys[(i-1)/2]>key; i=(i-1)/2)
+		heap->keys[i]=heap->keys[(i-1)/2];
+	heap->keys[i]=key;
+	return 0;
+}
+
+unsigned long long key_heap_pop(struct key_heap *heap)
+{
+	unsigned long long top=heap->keys[0], last=heap->keys[--heap->size];
+	size_t i=0, child;
+
+	while ((child=2*i+1)<heap->size)
+	{
+		if (child+1<heap->size && heap->keys[child+1]<heap->keys[child])
+			child++;
+		if (heap->keys[child]>=last)
+			break;
+		heap->keys[i]=heap->keys[child];
+		i=child;
+	}
+	if (heap->size>0)
+		heap->keys[i]=last;
+	return top;
+}
+
+// This function runs a Dijkstra search from a source over the values from 0 to max_value,
+// and computes the exact cost of every value to the source (backward, with the inverse
+// operators) or from the source (forward, with the operators). Only paths that stay
+// within the range are considered.
+// Inputs:
+//		int source		: The source of the search
+//		int max_value		: The largest value of the range
+//		int backward		: 1 for the costs to the source, 0 for the costs from it
+//		unsigned int *costs	: The costs of the values, TABLE_UNREACHABLE if they are not connected
+//		unsigned char *operations	: If not NULL, the operation that moves each value
+//					  towards the source (backward only), 4 bits per value
+// Output:
+//		The number of values connected to the source, or -1 in case of memory problem.
+long cost_table(int source, int max_value, int backward, unsigned int *costs, unsigned char *operations)
+{
+	size_t count=(size_t) max_value+1, i;
+	struct key_heap heap={NULL,0,0};
+	struct move moves[MAX_MOVES];
+	long reachable=0;
+
+	for (i=0;i<count;i++)
+		costs[i]=TABLE_UNREACHABLE;
+	costs[source]=0;
+	if (key_heap_push(&heap, (unsigned long long) source)<0)
+		goto memory;
+
+	while (heap.size>0)
+	{
+		unsigned long long key=key_heap_pop(&heap);
+		unsigned int cost=(unsigned int) (key>>32);
+		int node_value=(int) (key & 0xFFFFFFFFu), n;
+
+		if (cost>costs[node_value])
+			continue;	// The value has been reached again with a lower cost
+		reachable++;
+
+		n = backward ? predecessors(node_value, moves) : successors(node_value, moves);
+		for (i=0;i<(size_t) n;i++)
+		{
+			int u=moves[i].node_value;
+			unsigned long long c=(unsigned long long) cost+moves[i].cost;
+
+			if (u>max_value || c>=costs[u])
+				continue;
+			costs[u]=(unsigned int) c;
+			if (operations!=NULL)
+				operations[u/2]=(unsigned char) ((operations[u/2] & ~(15<<(4*(u%2)))) | (moves[i].operation<<(4*(u%2))));
+			if (key_heap_push(&heap, (c<<32) | (unsigned int) u)<0)
+				goto memory;
+		}
+	}
+	free(heap.keys);
+	return reachable;
+
+memory:
+	free(heap.keys);
+	return -1;
+}
+
+// This function runs a Dijkstra search backwards from a target over the values from 0
+// to max_value, with the inverse operators, and writes the exact cost to the target of
+// every value, and the operation that moves it towards the target, to a table file.
+// Only paths that stay within the range are considered.
+// Inputs:
+//		int target_value	: The target of the table
+//		int max_value		: The largest value of the table
+//		char* filename		: The table file
+// Output:
+//		0 --> The table has been written
+//		-1 --> Memory or file problem
+int precompute_table(int target_value, int max_value, char* filename)
+{
+	size_t count=(size_t) max_value+1;
+	unsigned int *costs=malloc(count*sizeof(unsigned int));
+	unsigned char *operations=calloc((count+1)/2, 1);
+	struct table_header header;
+	long reachable;
+	double t1=wall_clock();
+	FILE *fout;
+	int err=-1;
+
+	if (costs==NULL || operations==NULL)
+	{
+		printf("Memory exhausted while creating the table...\n");
+		goto done;
+	}
+	reachable=cost_table(target_value, max_value, 1, costs, operations);
+	if (reachable<0)
+		goto memory;
+
+	fout=fopen(filename, "wb");
+	if (fout==NULL)
+	{
+		printf("Cannot open output file %s.\n",filename);
+		goto done;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TABLE_MAGIC, sizeof(header.magic));
+	header.version=TABLE_VERSION;
+	header.target_value=target_value;
+	header.max_value=max_value;
+	if (fwrite(&header, sizeof(header), 1, fout)!=1 ||
+		fwrite(costs, sizeof(unsigned int), count, fout)!=count ||
+		fwrite(operations, 1, (count+1)/2, fout)!=(count+1)/2)
+		printf("Error while writing the table to %s.\n",filename);
+	else
+	{
+		printf("Table of %ld values for target %d written to %s (%ld values reach the target) in %f secs\n",
+			(long) count, target_value, filename, reachable, wall_clock()-t1);
+		err=0;
+	}
+	fclose(fout);
+	goto done;
+
+memory:
+	printf("Memory exhausted while creating the table...\n");
+done:
+	free(costs);
+	free(operations);
+	return err;
+}
+
+// This function chooses count landmarks over the values from 0 to max_value, computes the
+// costs between every value and each landmark with cost_table, and writes them to a
+// landmark file. The first landmark is max_value, and each next one is the value that is
+// the farthest from the landmarks already chosen (the largest cost to and back from the
+// nearest one), so that the landmarks lie at the borders of the graph.
+// Inputs:
+//		int count		: The number of landmarks, from 1 to MAX_LANDMARKS
+//		int max_value		: The largest value of the range
+//		char* filename		: The landmark file
+// Output:
+//		0 --> The landmarks have been written
+//		-1 --> Memory or file problem
+int precompute_landmarks(int count, int max_value, char* filename)
+{
+	size_t n=(size_t) max_value+1, v;
+	unsigned int *to=malloc(n*sizeof(unsigned int));
+	unsigned int *from=malloc(n*sizeof(unsigned int));
+	unsigned int *nearest=malloc(n*sizeof(unsigned int));
+	unsigned short *costs=malloc(n*count*2*sizeof(unsigned short));
+	struct landmark_header header;
+	double t1=wall_clock();
+	FILE *fout;
+	int i, landmark=max_value, err=-1;
+
+	if (to==NULL || from==NULL || nearest==NULL || costs==NULL)
+		goto memory;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LANDMARK_MAGIC, sizeof(header.magic));
+	header.version=LANDMARK_VERSION;
+	header.count=count;
+	header.max_value=max_value;
+	for (v=0;v<n;v++)
+		nearest[v]=UINT_MAX;
+
+	for (i=0;i<count;i++)
+	{
+		unsigned int largest_to=0, largest_from=0, farthest=0;
+
+		if (cost_table(landmark, max_value, 1, to, NULL)<0 || cost_table(landmark, max_value, 0, from, NULL)<0)
+			goto memory;
+		header.values[i]=landmark;
+		for (v=0;v<n;v++)
+		{
+			if (to[v]!=TABLE_UNREACHABLE && to[v]>largest_to)
+				largest_to=to[v];
+			if (from[v]!=TABLE_UNREACHABLE && from[v]>largest_from)
+				largest_from=from[v];
+		}
+		header.scales[i][0]=largest_to/(LANDMARK_UNREACHABLE-1)+1;
+		header.scales[i][1]=largest_from/(LANDMARK_UNREACHABLE-1)+1;
+
+		for (v=0;v<n;v++)
+		{
+			costs[2*(v*count+i)] = to[v]==TABLE_UNREACHABLE ? LANDMARK_UNREACHABLE : to[v]/header.scales[i][0];
+			costs[2*(v*count+i)+1] = from[v]==TABLE_UNREACHABLE ? LANDMARK_UNREACHABLE : from[v]/header.scales[i][1];
+
+			// Values that are not connected with a landmark both ways are never chosen
+			if (to[v]==TABLE_UNREACHABLE || from[v]==TABLE_UNREACHABLE)
+				nearest[v]=0;
+			else if ((unsigned long long) to[v]+from[v]<nearest[v])
+				nearest[v]=to[v]+from[v];
+			if (nearest[v]>farthest)
+			{
+				farthest=nearest[v];
+				landmark=(int) v;
+			}
+		}
+		printf("Landmark %d: %d (scales %u and %u)\n",i+1,header.values[i],header.scales[i][0],header.scales[i][1]);
+	}
+
+	fout=fopen(filename, "wb");
+	if (fout==NULL)
+	{
+		printf("Cannot open output file %s.\n",filename);
+		goto done;
+	}
+	if (fwrite(&header, sizeof(header), 1, fout)!=1 ||
+		fwrite(costs, 2*sizeof(unsigned short), n*count, fout)!=n*count)
+		printf("Error while writing the landmarks to %s.\n",filename);
+	else
+	{
+		printf("%d landmarks of %ld values written to %s in %f secs\n",count,(long) n,filename,wall_clock()-t1);
+		err=0;
+	}
+	fclose(fout);
+	goto done;
+
+memory:
+	printf("Memory exhausted while creating the landmarks...\n");
+done:
+	free(to);
+	free(from);
+	free(nearest);
+	free(costs);
+	return err;
+}
+
+// This function maps a file in memory, read only.
+// Output:
+//		The address of the file, with its size in *size, or NULL if the file cannot be
+//		mapped or is smaller than min_size.
+void *map_file(char* filename, size_t min_size, size_t *size)
+{
+	void *base;
+#ifdef _WIN32
+	HANDLE file, mapping;
+	LARGE_INTEGER file_size;
+
+	file=CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file==INVALID_HANDLE_VALUE)
+		return NULL;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart<(LONGLONG) min_size)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+	*size=(size_t) file_size.QuadPart;
+	mapping=CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping==NULL)
+		return NULL;
+	base=MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);		// The view keeps the mapping alive
+	return base;
+#else
+	struct stat st;
+	int fd=open(filename, O_RDONLY);
+
+	if (fd<0)
+		return NULL;
+	if (fstat(fd, &st)<0 || st.st_size<(off_t) min_size)
+	{
+		close(fd);
+		return NULL;
+	}
+	*size=(size_t) st.st_size;
+	base=mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);			// The mapping keeps the file open
+	return base==MAP_FAILED ? NULL : base;
+#endif
+}
+
+// This function maps a file in memory for reading and writing, shared with the other
+// processes that map it. A file that does not exist or is empty is created with size
+// zero bytes.
+// Output:
+//		The address of the file, or NULL if the file cannot be mapped or has another size.
+void *map_file_shared(char* filename, size_t size)
+{
+	void *base;
+#ifdef _WIN32
+	HANDLE file, mapping;
+	LARGE_INTEGER file_size;
+
+	file=CreateFileA(filename, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file==INVALID_HANDLE_VALUE)
+		return NULL;
+	if (!GetFileSizeEx(file, &file_size) || (file_size.QuadPart!=0 && file_size.QuadPart!=(LONGLONG) size))
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+	mapping=CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD) ((unsigned long long) size>>32), (DWORD) size, NULL);
+	CloseHandle(file);
+	if (mapping==NULL)
+		return NULL;
+	base=MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	CloseHandle(mapping);		// The view keeps the mapping alive
+	return base;
+#else
+	struct stat st;
+	int fd=open(filename, O_RDWR|O_CREAT, 0644);
+
+	if (fd<0)
+		return NULL;
+	if (fstat(fd, &st)<0 || (st.st_size!=0 && st.st_size!=(off_t) size) ||
+		(st.st_size==0 && ftruncate(fd, (off_t) size)<0))
+	{
+		close(fd);
+		return NULL;
+	}
+	base=mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);			// The mapping keeps the file open
+	return base==MAP_FAILED ? NULL : base;
+#endif
+}
+
+// This function unmaps a file mapped by map_file or map_file_shared.
+void unmap_file(void *base, size_t size)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(base);
+#else
+	munmap(base, size);
+#endif
+}
+
+// This function unmaps the table.
+void unload_table()
+{
+	if (table.base==NULL)
+		return;
+	unmap_file(table.base, table.size);
+	memset(&table, 0, sizeof(table));
+}
+
+// This function maps a table file in memory, read only, and checks its header.
+// Output:
+//		0 --> The table has been mapped into table
+//		-1 --> The file cannot be mapped or is not a valid table
+int load_table(char* filename)
+{
+	table.base=map_file(filename, sizeof(struct table_header), &table.size);
+	if (table.base==NULL)
+		return -1;
+	table.header=(struct table_header *) table.base;
+	if (memcmp(table.header->magic, TABLE_MAGIC, sizeof(table.header->magic))!=0 ||
+		table.header->version!=TABLE_VERSION ||
+		table.header->max_value<0 || table.header->max_value>MAX_VALUE ||
+		table_size(table.header->max_value)!=table.size)
+	{
+		unload_table();
+		return -1;
+	}
+	table.costs=(unsigned int *) (table.header+1);
+	table.operations=(unsigned char *) (table.costs+table.header->max_value+1);
+	return 0;
+}
+
+// The size of a landmark file with count landmarks and values from 0 to max_value.
+size_t landmark_size(int count, int max_value)
+{
+	return sizeof(struct landmark_header)+((size_t) max_value+1)*count*2*sizeof(unsigned short);
+}
+
+// This function unmaps the landmarks.
+void unload_landmarks()
+{
+	if (landmarks.base==NULL)
+		return;
+	unmap_file(landmarks.base, landmarks.size);
+	memset(&landmarks, 0, sizeof(landmarks));
+}
+
+// This function maps a landmark file in memory, read only, and checks its header.
+// Output:
+//		0 --> The landmarks have been mapped into landmarks
+//		-1 --> The file cannot be mapped or is not a valid landmark file
+int load_landmarks(char* filename)
+{
+	landmarks.base=map_file(filename, sizeof(struct landmark_header), &landmarks.size);
+	if (landmarks.base==NULL)
+		return -1;
+	landmarks.header=(struct landmark_header *) landmarks.base;
+	if (memcmp(landmarks.header->magic, LANDMARK_MAGIC, sizeof(landmarks.header->magic))!=0 ||
+		landmarks.header->version!=LANDMARK_VERSION ||
+		landmarks.header->count<1 || landmarks.header->count>MAX_LANDMARKS ||
+		landmarks.header->max_value<0 || landmarks.header->max_value>MAX_VALUE ||
+		landmark_size(landmarks.header->count, landmarks.header->max_value)!=landmarks.size)
+	{
+		unload_landmarks();
+		return -1;
+	}
+	landmarks.costs=(unsigned short *) (landmarks.header+1);
+	return 0;
+}
+
+// Returns 1 if a search can be answered by the table: the table has the same target
+// and the initial value is within its range.
+int uses_table(struct search_context *ctx)
+{
+	return table.base!=NULL && ctx->target_value==table.header->target_value &&
+		ctx->initial_value>=0 && ctx->initial_value<=table.header->max_value;
+}
+
+// One case of apply_operation, for an entry of OPERATORS.
+#define APPLY_OPERATION(op, op_name, op_applicable, op_value, op_cost) \
+	case op:	return (op_applicable) ? (int) (op_value) : -1;
+
+// Returns the value an operation leads to, or -1 if it cannot be applied to node_value.
+int apply_operation(int operation, int node_value)
+{
+	long long x=node_value, y;
+
+	switch (operation)
+	{
+		OPERATORS(APPLY_OPERATION)
+	}
+	return -1;
+}
+
+// This function builds the path from the initial value to the target with the table,
+// following the operation of each value, without any search.
+// Output:
+//		NULL --> The target cannot be reached within the range of the table
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *search_table(struct search_context *ctx)
+{
+	struct tree_node *last=ctx->root;
+	int node_value=ctx->initial_value;
+
+	if (table.costs[node_value]==TABLE_UNREACHABLE)
+		return NULL;
+	while (node_value!=ctx->target_value)
+	{
+		int operation=table_operation(table.operations, node_value);
+		int next_value=apply_operation(operation, node_value);
+		struct tree_node *child;
+
+		if (operation<increase || operation>Root || next_value<0 || next_value>table.header->max_value ||
+			table.costs[next_value]>=table.costs[node_value])
+		{
+			search_message(ctx, "The table is corrupted. Search is terminated...\n");
+			return NULL;
+		}
+		child=alloc_tree_node(ctx);
+		if (child==NULL)
+		{
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return NULL;
+		}
+		child->parent=last;
+		child->operation=operation;
+		child->node_value=next_value;
+		child->node_depth=last->node_depth+1;
+		child->g=last->g+(table.costs[node_value]-table.costs[next_value]);
+		child->h=heuristic(ctx, next_value);
+		child->f=0;
+		last=child;
+		node_value=next_value;
+	}
+	return last;
+}
+
+// The size of a cache file.
+size_t cache_size()
+{
+	return sizeof(struct cache_header)+(size_t) CACHE_SETS*CACHE_WAYS*sizeof(struct cache_slot);
+}
+
+// This function unmaps the cache.
+void unload_cache()
+{
+	if (cache.base==NULL)
+		return;
+	unmap_file(cache.base, cache.size);
+	memset(&cache, 0, sizeof(cache));
+}
+
+// This function maps a cache file in memory, creating it if it does not exist, and
+// checks its header.
+// Output:
+//		0 --> The cache has been mapped into cache
+//		-1 --> The file cannot be mapped or is not a valid cache file
+int load_cache(char* filename)
+{
+	struct cache_header *header;
+
+	cache.size=cache_size();
+	cache.base=map_file_shared(filename, cache.size);
+	if (cache.base==NULL)
+		return -1;
+	header=(struct cache_header *) cache.base;
+	if (header->version==0)
+	{
+		// A new file: the processes that create it at the same time write the same header
+		header->version=CACHE_VERSION;
+		header->sets=CACHE_SETS;
+		header->ways=CACHE_WAYS;
+		header->max_steps=CACHE_MAX_STEPS;
+		memory_fence();
+		memcpy(header->magic, CACHE_MAGIC, sizeof(header->magic));
+	}
+	if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic))!=0 ||
+		header->version!=CACHE_VERSION || header->sets!=CACHE_SETS ||
+		header->ways!=CACHE_WAYS || header->max_steps!=CACHE_MAX_STEPS)
+	{
+		unload_cache();
+		return -1;
+	}
+	cache.header=header;
+	cache.slots=(struct cache_slot *) (header+1);
+	return 0;
+}
+
+// This function adds bytes to a 64-bit FNV-1a hash.
+unsigned long long hash_bytes(unsigned long long hash, const void *bytes, size_t size)
+{
+	const unsigned char *p=(const unsigned char *) bytes;
+	size_t i;
+
+	for (i=0;i<size;i++)
+		hash=(hash^p[i])*1099511628211ULL;
+	return hash;
+}
+
+// Returns a hash of the options that change the solution of a method: the frontier, the
+// detection of repeated values, the header of the landmark file (its landmarks and range),
+// the weight of arastar, and the mode and the methods of portfolio. Only the solutions
+// found with the same options are taken from the cache.
+unsigned long long cache_options()
+{
+	unsigned long long hash=14695981039346656037ULL;
+
+	hash=hash_bytes(hash, &frontier_kind, sizeof(frontier_kind));
+	hash=hash_bytes(hash, &duplicate_kind, sizeof(duplicate_kind));
+	if (landmarks.base!=NULL)
+		hash=hash_bytes(hash, landmarks.header, sizeof(struct landmark_header));
+	hash=hash_bytes(hash, &ara_weight, sizeof(ara_weight));
+	hash=hash_bytes(hash, &portfolio_mode, sizeof(portfolio_mode));
+	hash=hash_bytes(hash, portfolio_methods, portfolio_count*sizeof(int));
+	return hash;
+}
+
+// Returns 1 if the solutions of a method are optimal, so that every part of a solution is
+// an optimal solution too: breadth and pbreadth (in steps), bidirectional and hdastar (in cost).
+int caches_subpaths(int method)
+{
+	return method==breadth || method==bidirectional || method==hdastar || method==pbreadth;
+}
+
+// Returns the bit of a value in the values of a cache slot.
+unsigned long long cache_bit(int node_value)
+{
+	return 1ULL<<(((unsigned int) node_value*2654435761u)>>26);
+}
+
+// Returns the first slot of the set of a query in the cache.
+struct cache_slot *cache_set(int method, int initial_value, int target_value)
+{
+	unsigned int hash=(unsigned int) method*40503u ^ (unsigned int) initial_value*2654435761u ^
+		(unsigned int) target_value*2246822519u;
+	return &cache.slots[(size_t) (hash>>7)%CACHE_SETS*CACHE_WAYS];
+}
+
+// This function copies a slot of the cache (see struct cache_slot).
+// Output:
+//		1 --> The copy is consistent and holds a solution
+//		0 --> The slot is empty or is being written
+int read_cache_slot(struct cache_slot *slot, struct cache_slot *copy)
+{
+	long long sequence=atomic_load_long_long(&slot->sequence);
+
+	if (sequence&1)
+		return 0;
+	memcpy(copy, slot, sizeof(struct cache_slot));
+	memory_fence();
+	return atomic_load_long_long(&slot->sequence)==sequence && copy->length>0 && copy->length<=CACHE_MAX_STEPS;
+}
+
+// Returns the position of a value in the path of a cached solution (0 for its initial
+// value), from position first on, or -1 if it is not on the path.
+int cached_position(struct cache_slot *slot, int node_value, int first)
+{
+	int i;
+
+	for (i=first;i<=slot->length;i++)
+		if ((i==0 ? slot->initial_value : slot->steps[i-1].node_value)==node_value)
+			return i;
+	return -1;
+}
+
+// This function builds the path of a query from the moves first+1 to last of a cached
+// solution, in the search tree, as search_table does from the table.
+// Output:
+//		NULL --> Memory problem
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *cached_path(struct search_context *ctx, struct cache_slot *slot, int first, int last)
+{
+	struct tree_node *node=ctx->root;
+	int base_g = first>0 ? slot->steps[first-1].g : 0;
+	int i;
+
+	for (i=first;i<last;i++)
+	{
+		struct tree_node *child=alloc_tree_node(ctx);
+
+		if (child==NULL)
+		{
+			search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return NULL;
+		}
+		child->parent=node;
+		child->operation=slot->steps[i].operation;
+		child->node_value=slot->steps[i].node_value;
+		child->node_depth=node->node_depth+1;
+		child->g=slot->steps[i].g-base_g;
+		child->h=heuristic(ctx, child->node_value);
+		child->f=0;
+		node=child;
+	}
+	return node;
+}
+
+// This function answers a search from the cache: with a solution of the same query, or,
+// for the methods with optimal solutions (see caches_subpaths), with the part of any
+// cached solution that goes from the initial value to the target.
+// Output:
+//		NULL --> The query is not in the cache
+//		struct tree_node*	: The node of the target at the end of the path.
+struct tree_node *search_cache(struct search_context *ctx)
+{
+	struct cache_slot *set=cache_set(ctx->method, ctx->initial_value, ctx->target_value);
+	struct cache_slot copy;
+	unsigned long long bits=cache_bit(ctx->initial_value)|cache_bit(ctx->target_value);
+	unsigned long long options=cache_options();
+	int i, first, last;
+
+	atomic_add_long(&cache.lookups, 1);
+	for (i=0;i<CACHE_WAYS;i++)
+		if (set[i].initial_value==ctx->initial_value && set[i].target_value==ctx->target_value &&
+			set[i].method==ctx->method && set[i].options==options && read_cache_slot(&set[i], &copy) &&
+			copy.initial_value==ctx->initial_value && copy.target_value==ctx->target_value &&
+			copy.method==ctx->method && copy.options==options)
+		{
+			atomic_store_long_long(&set[i].last_used, atomic_add_long_long(&cache.header->clock, 1));
+			atomic_add_long(&cache.hits, 1);
+			return cached_path(ctx, &copy, 0, copy.length);
+		}
+
+	if (!caches_subpaths(ctx->method))
+		return NULL;
+	for (i=0;i<CACHE_SETS*CACHE_WAYS;i++)
+	{
+		struct cache_slot *slot=&cache.slots[i];
+
+		if ((slot->values&bits)!=bits || slot->method!=ctx->method || slot->options!=options ||
+			!read_cache_slot(slot, &copy) || copy.method!=ctx->method || copy.options!=options)
+			continue;
+		first=cached_position(&copy, ctx->initial_value, 0);
+		last = first>=0 ? cached_position(&copy, ctx->target_value, first+1) : -1;
+		if (last>0)
+		{
+			atomic_store_long_long(&slot->last_used, atomic_add_long_long(&cache.header->clock, 1));
+			atomic_add_long(&cache.hits, 1);
+			atomic_add_long(&cache.subpath_hits, 1);
+			return cached_path(ctx, &copy, first, last);
+		}
+	}
+	return NULL;
+}
+
+// This function stores the solution of a search in the cache, in the set of its query,
+// in an empty slot or else in the least recently used one. Solutions longer than
+// CACHE_MAX_STEPS, and solutions of searches stopped by a budget, are not stored.
+void store_cache(struct search_context *ctx, struct tree_node *solution_node)
+{
+	struct cache_slot *set=cache_set(ctx->method, ctx->initial_value, ctx->target_value), *slot=NULL;
+	struct tree_node *node;
+	unsigned long long options=cache_options();
+	long long sequence;
+	int i;
+
+	if (solution_node->node_depth<1 || solution_node->node_depth>CACHE_MAX_STEPS || ctx->stats.stopped)
+		return;
+	for (i=0;i<CACHE_WAYS;i++)
+	{
+		if (set[i].length>0 && set[i].initial_value==ctx->initial_value &&
+			set[i].target_value==ctx->target_value && set[i].method==ctx->method && set[i].options==options)
+			return;		// Already stored by another thread or process
+		if (slot==NULL || (slot->length>0 && (set[i].length==0 || set[i].last_used<slot->last_used)))
+			slot=&set[i];
+	}
+
+	sequence=atomic_load_long_long(&slot->sequence);
+	if ((sequence&1) || !atomic_cas_long_long(&slot->sequence, sequence, sequence+1))
+		return;		// Another writer holds the slot
+	slot->method=ctx->method;
+	slot->options=options;
+	slot->initial_value=ctx->initial_value;
+	slot->target_value=ctx->target_value;
+	slot->length=solution_node->node_depth;
+	slot->values=cache_bit(ctx->initial_value);
+	for (node=solution_node; node->parent!=NULL; node=node->parent)
+	{
+		struct cache_step *step=&slot->steps[node->node_depth-1];
+		step->node_value=node->node_value;
+		step->g=node->g;
+		step->operation=node->operation;
+		slot->values|=cache_bit(node->node_value);
+	}
+	slot->last_used=atomic_add_long_long(&cache.header->clock, 1);
+	atomic_store_long_long(&slot->sequence, sequence+2);
+	atomic_add_long(&cache.stores, 1);
+}
+
+// This function prints the hit rate of the cache in this process.
+void print_cache_stats(FILE *fout)
+{
+	fprintf(fout,"Cache: %ld lookups, %ld hits (%ld from parts of cached solutions), hit rate %.1f%%, %ld solutions stored\n",
+		cache.lookups, cache.hits, cache.subpath_hits, cache.lookups>0 ? 100.0*cache.hits/cache.lookups : 0.0, cache.stores);
+}
+
+#define HDA_BATCH_SIZE	64	// Nodes sent to another thread at once
+#define HDA_EXPANSIONS	64	// Expansions between two checks of the queue of a thread
+
+// A batch of nodes sent to the thread that owns their values.
+struct hda_batch
+{
+	struct hda_batch *next;
+	int count;
+	struct tree_node *nodes[HDA_BATCH_SIZE];
+};
+
+struct hda_search;
+
+// A thread of hdastar. It owns the values that hash to it, with their frontier and
+// closed set in its own context, and receives the nodes of these values from the other
+// threads through its inbox: a lock-free stack of batches, where every thread pushes
+// with compare-and-swap and the owner takes all the batches at once.
+struct hda_worker
+{
+	struct search_context ctx;
+	struct hda_batch *inbox;
+	struct hda_batch **outbox;	// The batch being filled for each thread
+	struct hda_search *search;
+	int index;
+	long memory;			// The search memory of the thread last added to search->memory
+	thread_t thread;
+};
+
+// The shared state of an hdastar search. work is the number of busy threads plus the
+// number of batches that have been sent and not yet received: it only reaches 0 when
+// every thread is idle and no node is on its way, and then the search is over.
+struct hda_search
+{
+	int count;
+	struct hda_worker *workers;
+	long work;
+	long stop;			// STOP_TIME, STOP_NODES or STOP_MEMORY when a budget is exhausted, -1 --> memory problem
+	long expanded;			// Nodes expanded by all the threads, for --max-expanded
+	long memory;			// Search memory of all the threads, for --max-memory
+	long best_cost;			// The cost of the best solution found so far
+	struct tree_node *best_node;
+	mutex_t lock;			// Protects best_node
+	double t1;
+	long *cancel;			// The cancellation of the search (see search_portfolio), NULL if none
+};
+
+// Returns the thread that owns a value. The hash differs from the one of the closed set,
+// so that the values of a thread are still spread over its closed set.
+int hda_owner(struct hda_search *search, int node_value)
+{
+	return (int) ((((unsigned int) node_value*2246822519u)>>13) % (unsigned int) search->count);
+}
+
+// This function adds a node to the frontier of the thread that owns its value, unless
+// the value has already been reached with a lower or equal cost.
+// Output:
+//		0 --> The node has been added or rejected
+//		-1 --> Memory problem
+int hda_insert(struct hda_worker *worker, struct tree_node *node)
+{
+	struct closed_entry *entry=add_closed(&worker->ctx.closed, node->node_value);
+
+	if (entry==NULL)
+		return -1;
+	if (entry->n!=NULL && entry->g<=node->g)
+	{
+		worker->ctx.stats.duplicates++;
+		return 0;
+	}
+	entry->g=node->g;
+	entry->n=node;
+	if (heap_push(&worker->ctx.frontier_heap, node)<0)
+		return -1;
+	note_frontier_size(&worker->ctx, worker->ctx.frontier_heap.size);
+	return 0;
+}
+
+// This function pushes the batch of a worker for another thread into the inbox of that thread.
+void hda_flush(struct hda_worker *worker, int owner)
+{
+	struct hda_batch *batch=worker->outbox[owner], *head;
+	struct hda_worker *target=&worker->search->workers[owner];
+
+	if (batch==NULL)
+		return;
+	worker->outbox[owner]=NULL;
+	atomic_add_long(&worker->search->work, 1);
+	do
+	{
+		head=atomic_load_pointer(&target->inbox);
+		batch->next=head;
+	} while (!atomic_cas_pointer(&target->inbox, head, batch));
+}
+
+// This function sends a node to the thread that owns its value (or adds it to the
+// frontier of the worker if the worker owns it).
+// Output:
+//		0 --> The node has been sent
+//		-1 --> Memory problem
+int hda_send(struct hda_worker *worker, struct tree_node *node)
+{
+	int owner=hda_owner(worker->search, node->node_value);
+	struct hda_batch *batch;
+
+	if (owner==worker->index)
+		return hda_insert(worker, node);
+	batch=worker->outbox[owner];
+	if (batch==NULL)
+	{
+		batch=(struct hda_batch*) malloc(sizeof(struct hda_batch));
+		if (batch==NULL)
+			return -1;
+		batch->count=0;
+		worker->outbox[owner]=batch;
+	}
+	batch->nodes[batch->count++]=node;
+	if (batch->count==HDA_BATCH_SIZE)
+		hda_flush(worker, owner);
+	return 0;
+}
+
+// This function expands a node of hdastar: the children that may still lead to a
+// solution cheaper than the best one are sent to their owners.
+// Output:
+//		0 --> The node has been expanded
+//		-1 --> Memory problem
+int hda_expand(struct hda_worker *worker, struct tree_node *current_node, long best_cost)
+{
+	struct move moves[MAX_MOVES];
+	int i, count=successors(current_node->node_value, moves);
+
+	worker->ctx.expanded_nodes++;
+	for (i=0;i<count;i++)
+	{
+		long g=(long) current_node->g+moves[i].cost;
+		int h=heuristic(&worker->ctx, moves[i].node_value);
+		struct tree_node *child;
+
+		if (g>INT_MAX || f(g,h,hdastar)>=best_cost)
+			continue;
+		child=alloc_tree_node(&worker->ctx);
+		if (child==NULL)
+			return -1;
+		child->parent=current_node;
+		child->operation=moves[i].operation;
+		child->node_value=moves[i].node_value;
+		child->node_depth=current_node->node_depth+1;
+		child->g=g;
+		child->h=h;
+		child->f=f(child->g,child->h,hdastar);
+		worker->ctx.stats.generated++;
+		worker->ctx.stats.operations[child->operation]++;
+		if (hda_send(worker, child)<0)
+			return -1;
+	}
+	return 0;
+}
+
+// The main function of a thread of hdastar. The thread alternates between receiving the
+// nodes sent to it and expanding the best nodes of its frontier, until every thread is
+// idle and no node is on its way. A solution is kept when its node is extracted from a
+// frontier; nodes that cannot lead to a cheaper solution are dropped.
+void hda_worker_main(void *argument)
+{
+	struct hda_worker *worker=(struct hda_worker*) argument;
+	struct hda_search *search=worker->search;
+	struct node_heap *heap=&worker->ctx.frontier_heap;
+	int busy=1, i, expansions;
+	double c1=cpu_clock();
+
+	while (atomic_load_long(&search->stop)==0)
+	{
+		struct hda_batch *batch=atomic_swap_pointer(&worker->inbox, NULL);
+		long best_cost;
+
+		if (batch!=NULL && !busy)
+		{
+			atomic_add_long(&search->work, 1);
+			busy=1;
+		}
+		while (batch!=NULL)
+		{
+			struct hda_batch *next=batch->next;
+			for (i=0;i<batch->count;i++)
+				if (hda_insert(worker, batch->nodes[i])<0)
+					atomic_store_long(&search->stop, -1);
+			free(batch);
+			atomic_add_long(&search->work, -1);
+			batch=next;
+		}
+
+		best_cost=atomic_load_long(&search->best_cost);
+		for (expansions=0; heap->size>0 && expansions<HDA_EXPANSIONS; )
+		{
+			struct tree_node *current_node=heap->entries[0].n;
+
+			heap_pop(heap);
+			if (lookup_closed(&worker->ctx.closed, current_node->node_value)!=current_node ||
+				current_node->f>=best_cost)
+				continue;	// Stale node, or no better than the best solution
+			if (is_solution(&worker->ctx, current_node->node_value))
+			{
+				mutex_lock(&search->lock);
+				if (current_node->g<search->best_cost)
+				{
+					search->best_node=current_node;
+					atomic_store_long(&search->best_cost, current_node->g);
+				}
+				mutex_unlock(&search->lock);
+				best_cost=atomic_load_long(&search->best_cost);
+				continue;
+			}
+			if (hda_expand(worker, current_node, best_cost)<0)
+				atomic_store_long(&search->stop, -1);
+			expansions++;
+		}
+		for (i=0;i<search->count;i++)
+			hda_flush(worker, i);
+
+		// The budgets are checked once per round, for all the threads together
+		if (search->cancel!=NULL && atomic_load_long(search->cancel))
+			atomic_store_long(&search->stop, STOP_CANCEL);
+		if (wall_clock()-search->t1 > time_limit)
+			atomic_store_long(&search->stop, STOP_TIME);
+		if (max_expanded>0 && atomic_add_long(&search->expanded, expansions)+expansions>=max_expanded)
+			atomic_store_long(&search->stop, STOP_NODES);
+		if (max_memory>0)
+		{
+			long memory=search_memory(&worker->ctx);
+			if (atomic_add_long(&search->memory, memory-worker->memory)+memory-worker->memory>max_memory)
+				atomic_store_long(&search->stop, STOP_MEMORY);
+			worker->memory=memory;
+		}
+		if (heap->size==0)
+		{
+			if (busy)
+			{
+				atomic_add_long(&search->work, -1);
+				busy=0;
+			}
+			if (atomic_load_long(&search->work)==0)
+				break;
+		}
+		thread_yield();		// Lets the other threads run when there are more threads than processors
+	}
+	worker->ctx.stats.cpu_time+=cpu_clock()-c1;
+}
+
+// This function implements hdastar, a parallel A* where each thread owns the values
+// that hash to it (see hda_owner). With an admissible and consistent heuristic, and the
+// nodes that are reached again with a lower cost being expanded again, the solution is
+// optimal. When the search is over, the search trees of the threads are moved to the
+// context, so that the solution remains valid until end_search.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: The node of the target at the end of an optimal path.
+struct tree_node *search_parallel(struct search_context *ctx)
+{
+	struct hda_search search;
+	struct tree_node *solution_node=NULL;
+	int i, j, started, count = search_threads>0 ? search_threads : cpu_count();
+
+	memset(&search, 0, sizeof(search));
+	search.count=count;
+	search.work=count;
+	search.best_cost=LONG_MAX;
+	search.t1=ctx->t1;
+	search.cancel=ctx->cancel;
+	mutex_init(&search.lock);
+	search.workers=(struct hda_worker*) calloc(count, sizeof(struct hda_worker));
+	if (search.workers==NULL)
+	{
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+		mutex_destroy(&search.lock);
+		return NULL;
+	}
+	for (i=0;i<count;i++)
+	{
+		struct hda_worker *worker=&search.workers[i];
+		init_search_context(&worker->ctx);
+		worker->ctx.method=hdastar;
+		worker->ctx.initial_value=ctx->initial_value;
+		worker->ctx.target_value=ctx->target_value;
+		worker->ctx.t1=ctx->t1;
+		worker->search=&search;
+		worker->index=i;
+		worker->outbox=(struct hda_batch**) calloc(count, sizeof(struct hda_batch*));
+		if (worker->outbox==NULL)
+			search.stop=-1;
+	}
+	if (search.stop==0 && hda_insert(&search.workers[hda_owner(&search, ctx->root->node_value)], ctx->root)<0)
+		search.stop=-1;
+
+	for (started=0; started<count && search.stop==0; started++)
+		if (thread_create(&search.workers[started].thread, hda_worker_main, &search.workers[started])<0)
+		{
+			atomic_store_long(&search.stop, -1);
+			break;
+		}
+	for (i=0;i<started;i++)
+		thread_join(search.workers[i].thread);
+
+	if (search.stop>0)
+		ctx->stats.stopped=search.stop;
+	else if (search.stop<0)
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	else
+		solution_node=search.best_node;
+
+	// The search trees of the threads become part of the search tree of the context
+	for (i=0;i<count;i++)
+	{
+		struct hda_worker *worker=&search.workers[i];
+		struct tree_chunk *last=worker->ctx.tree_chunks;
+
+		if (last!=NULL)
+		{
+			while (last->next!=NULL)
+				last=last->next;
+			last->next=ctx->tree_chunks->next;
+			ctx->tree_chunks->next=worker->ctx.tree_chunks;
+			worker->ctx.tree_chunks=NULL;
+		}
+		while (worker->inbox!=NULL)
+		{
+			struct hda_batch *next=worker->inbox->next;
+			free(worker->inbox);
+			worker->inbox=next;
+		}
+		if (worker->outbox!=NULL)
+			for (j=0;j<count;j++)
+				free(worker->outbox[j]);
+		free(worker->outbox);
+		ctx->expanded_nodes+=worker->ctx.expanded_nodes;
+		end_search(&worker->ctx);
+		add_stats(&ctx->stats, &worker->ctx.stats);
+		// The sum of the peaks of the threads, an upper bound of the frontier at any time
+		ctx->stats.peak_frontier+=worker->ctx.stats.peak_frontier;
+		free_search_context(&worker->ctx);
+	}
+	free(search.workers);
+	mutex_destroy(&search.lock);
+	print_stop(ctx);
+	return solution_node;
+}
+
+struct tree_node *search_method(struct search_context *ctx);	// Runs the methods of portfolio
+
+// A method raced by portfolio, with its own search context, so that it shares nothing
+// with the other methods.
+struct portfolio_run
+{
+	struct search_context ctx;
+	struct portfolio_search *search;
+	struct tree_node *solution_node;	// The solution found by the method, NULL if none
+	thread_t thread;
+};
+
+// The shared state of a portfolio search.
+struct portfolio_search
+{
+	struct portfolio_run runs[MAX_PORTFOLIO];
+	int count;
+	int initial_value;
+	int target_value;
+	long cancel;			// Set when the methods still running must stop
+	int winner;			// The run whose solution is returned, -1 until a solution is found
+	mutex_t lock;			// Protects winner
+};
+
+// This function is the thread of a method of portfolio. The first solution found wins, and
+// cancels the other methods with PORTFOLIO_FIRST; with PORTFOLIO_BEST a solution only wins
+// if it is cheaper than the solutions found before it.
+void portfolio_worker_main(void *argument)
+{
+	struct portfolio_run *run=(struct portfolio_run*) argument;
+	struct portfolio_search *search=run->search;
+	struct search_context *ctx=&run->ctx;
+
+	if (initialize_search(ctx, search->initial_value, search->target_value, ctx->method)==0)
+		run->solution_node=search_method(ctx);
+	else
+		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+	stop_clocks(ctx);
+	if (run->solution_node==NULL)
+		return;
+
+	mutex_lock(&search->lock);
+	if (search->winner<0 || (portfolio_mode==PORTFOLIO_BEST && run->solution_node->g<search->runs[search->winner].solution_node->g))
+		search->winner=(int) (run-search->runs);
+	mutex_unlock(&search->lock);
+	if (portfolio_mode==PORTFOLIO_FIRST)
+		atomic_store_long(&search->cancel, 1);
+}
+
+// This function implements portfolio: the methods of --portfolio-methods are run at the same
+// time, each in its own thread and with its own search context, and the solution of the
+// winner is returned (see portfolio_worker_main). The budgets apply to each method. The
+// methods that lose are cancelled through ctx->cancel, that over_budget checks once every
+// BUDGET_CHECK_INTERVAL expansions (pbreadth once per level, hdastar once per round).
+// Output:
+//		NULL --> No method has found a solution
+//		struct tree_node*	: The node of the solution of the winner.
+struct tree_node *search_portfolio(struct search_context *ctx)
+{
+	struct portfolio_search search;
+	struct tree_node *solution_node=NULL;
+	int i, started;
+
+	memset(&search, 0, sizeof(search));
+	search.count=portfolio_count;
+	search.initial_value=ctx->initial_value;
+	search.target_value=ctx->target_value;
+	search.winner=-1;
+	mutex_init(&search.lock);
+	for (i=0;i<search.count;i++)
+	{
+		struct portfolio_run *run=&search.runs[i];
+		init_search_context(&run->ctx);
+		run->ctx.method=portfolio_methods[i];
+		run->ctx.cancel=&search.cancel;
+		run->ctx.quiet=1;
+		run->search=&search;
+	}
+
+	for (started=0; started<search.count; started++)
+		if (thread_create(&search.runs[started].thread, portfolio_worker_main, &search.runs[started])<0)
+			break;
+	if (started==0)
+		search_message(ctx, "Cannot start the threads of the portfolio. Search is terminated...\n");
+	for (i=0;i<started;i++)
+		thread_join(search.runs[i].thread);
+
+	if (search.winner>=0)
+	{
+		struct portfolio_run *run=&search.runs[search.winner];
+		struct tree_chunk *last=run->ctx.tree_chunks;
+
+		// The search tree of the winner becomes part of the search tree of the context
+		while (last->next!=NULL)
+			last=last->next;
+		last->next=ctx->tree_chunks->next;
+		ctx->tree_chunks->next=run->ctx.tree_chunks;
+		run->ctx.tree_chunks=NULL;
+		solution_node=run->solution_node;
+		ctx->stats.winner=run->ctx.method;
+
+		// The report of the winner, that has been quiet while it ran
+		if (run->ctx.method==arastar)
+			search_message(ctx, "Best solution: cost %d, at most %.3f times the optimum\n",solution_node->g,run->ctx.suboptimality);
+	}
+	for (i=0;i<search.count;i++)
+	{
+		struct portfolio_run *run=&search.runs[i];
+
+		if (solution_node==NULL && ctx->stats.stopped==0 && run->ctx.stats.stopped!=STOP_CANCEL)
+			ctx->stats.stopped=run->ctx.stats.stopped;
+		ctx->expanded_nodes+=run->ctx.expanded_nodes;
+		end_search(&run->ctx);
+		add_stats(&ctx->stats, &run->ctx.stats);
+		// The peak of the winner, or the largest one if no method has won
+		if (i==search.winner || (search.winner<0 && run->ctx.stats.peak_frontier>ctx->stats.peak_frontier))
+			ctx->stats.peak_frontier=run->ctx.stats.peak_frontier;
+		free_search_context(&run->ctx);
+	}
+	mutex_destroy(&search.lock);
+	print_stop(ctx);
+	return solution_node;
+}
+
+// This function implements depth. The children of a node are generated one at a time
+// (see find_next_child_depth), and a node is released when it has no child left. So the
+// search only holds the current branch, followed through the parents of its last node,
+// and not the siblings of its nodes, which depth does not need until the branch below
+// them has been explored: the frontier list is only used to hand over the root, and the
+// peak frontier is the longest branch. The nodes are expanded in the same order as with
+// all the children added at once at the front of the frontier, but fewer children are
+// generated: those of a value expanded meanwhile are rejected when they are generated,
+// instead of being skipped by close_node, and the siblings left when the target is found
+// are never generated. Apart from the branch, the memory is the closed set, one entry per
+// expanded value (none with --duplicates path).
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: A pointer to a search-tree leaf node that corresponds to a solution.
+struct tree_node *search_depth(struct search_context *ctx)
+{
+	struct tree_node *current_node=ctx->frontier_head->n, *child, *parent;
+	int err;
+
+	remove_frontier_front(ctx);
+	while (current_node!=NULL)
+	{
+		if (current_node->next_operation<0)
+		{
+			// A new node at the end of the branch
+			if (over_budget(ctx))
+			{
+				print_stop(ctx);
+				return NULL;
+			}
+			if (is_solution(ctx, current_node->node_value))
+				return current_node;
+
+			// Already expanded values are skipped
+			err=close_node(ctx, current_node);
+			if (err<0)
+			{
+				search_message(ctx, "Memory exhausted while growing the closed set. Search is terminated...\n");
+				return NULL;
+			}
+			if (err>0)
+			{
+				ctx->expanded_nodes++;
+				current_node->next_operation=OPERATOR_COUNT;
+			}
+		}
+
+		err=current_node->next_operation<0 ? 0 : find_next_child_depth(ctx, current_node, &child);
+		if (err<0)
+		{
+			search_message(ctx, "Memory exhausted while creating new search-tree node. Search is terminated...\n");
+			return NULL;
+		}
+		if (err>0)
+		{
+			note_frontier_size(ctx, child->node_depth+1);
+			current_node=child;
+			continue;
+		}
+
+		// A node that has been skipped, or has no child left, leaves the branch
+		parent=current_node->parent;
+		if (current_node!=ctx->root)
+			release_tree_node(ctx, current_node);
+		current_node=parent;
+	}
+
+	return NULL;
+}
+
+// This function implements at the higest level the search algorithms.
+// The various search algorithms differ only in the way the insert
+// new nodes into the frontier, so most of the code is commmon for all algorithms.
+// Inputs:
+//		struct search_context *ctx	: The context of the search, with the root in frontier_head
+//						  (or frontier_heap or frontier_buckets for best and astar).
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: A pointer to a search-tree leaf node that corresponds to a solution.
+struct tree_node *search_method(struct search_context *ctx)
+{
+	int method=ctx->method;
+	int heap=uses_heap(method), buckets=uses_buckets(method);
+	int err;
+	struct tree_node *current_node;
+
+	if (uses_table(ctx))
+		return search_table(ctx);
+	if (method==bidirectional)
+		return search_bidirectional(ctx);
+	if (method==idastar || method==iddfs)
+		return search_iterative(ctx);
+	if (uses_dense(method))
+		return search_dense(ctx);
+	if (uses_compact(method))
+		return search_compact(ctx);
+	if (method==pbreadth)
+		return search_levels(ctx);
+	if (method==hdastar)
+		return search_parallel(ctx);
+	if (method==arastar)
+		return search_anytime(ctx);
+	if (method==portfolio)
+		return search_portfolio(ctx);
+	if (method==depth)
+		return search_depth(ctx);
+
+	while (heap ? ctx->frontier_heap.size>0 : buckets ? ctx->frontier_buckets.count+ctx->frontier_buckets.overflow.size>0 : ctx->frontier_head!=NULL)
+	{
+		if (over_budget(ctx))
+		{
+			print_stop(ctx);
+			return NULL;
+		}
+
+		// Extract the first node from the frontier
+		if (heap)
+			current_node = ctx->frontier_heap.entries[0].n;
+		else if (buckets)
+			current_node = first_bucket_node(&ctx->frontier_buckets);
+		else
+			current_node = ctx->frontier_head->n;
+
+		if (is_solution(ctx, current_node->node_value))
+			return current_node;
+
+		// Delete the first node of the frontier
+		if (heap)
+			heap_pop(&ctx->frontier_heap);
+		else if (buckets)
+			remove_first_bucket_node(ctx);
+		else
+			remove_frontier_front(ctx);
+
+		// Stale nodes of astar are skipped
+		err=close_node(ctx, current_node);
+		if (err<0)
+		{
+			search_message(ctx, "Memory exhausted while growing the closed set. Search is terminated...\n");
+			return NULL;
+		}
+		if (err==0)
+			continue;
+		ctx->expanded_nodes++;
+
+		// Find the children of the extracted node
+		err=ctx->find_children(ctx, current_node);
+
+		if (err<0)
+	        {
+            		search_message(ctx, "Memory exhausted while creating new frontier node. Search is terminated...\n");
+			return NULL;
+        	}
+	}
+
+	return NULL;
+}
+
+// This function solves a search with its method. With --cache, the query is looked up in
+// the cache first, and the solution found by the search is stored in the cache.
+// Output:
+//		NULL --> The problem cannot be solved
+//		struct tree_node*	: A pointer to a search-tree leaf node that corresponds to a solution.
+struct tree_node *search(struct search_context *ctx)
+{
+	struct tree_node *solution_node;
+
+	if (cache.base==NULL || uses_table(ctx))
+		return search_method(ctx);
+	solution_node=search_cache(ctx);
+	if (solution_node!=NULL)
+		return solution_node;
+	solution_node=search_method(ctx);
+	if (solution_node!=NULL)
+		store_cache(ctx, solution_node);
+	return solution_node;
+}
+
+// This function measures the speedup of hdastar or pbreadth: the same problem is solved
+// with 1, 2, 4... up to max_threads threads, and the time, the processor time of all the
+// threads, the nodes expanded and the cost of the solution are printed for each number of
+// threads. The costs must all be the same. For pbreadth, the critical time (see struct
+// level_search) is printed too, with the speedup it allows: the speedup with a processor
+// per thread, that can be measured on a machine with fewer processors.
+// Output:
+//		0 --> All the runs found the same solution cost
+//		-1 --> A run failed or found a different cost
+int benchmark_parallel(int method, int initial_value, int target_value, int max_threads)
+{
+	struct search_context ctx;
+	double time1=0, cpu1=0;
+	int threads, cost=-1, err=0;
+
+	printf("%s from %d to %d on %d processors\n",method_name(method),initial_value,target_value,cpu_count());
+	for (threads=1; ; threads = 2*threads<max_threads ? 2*threads : max_threads)
+	{
+		struct tree_node *solution_node=NULL;
+
+		search_threads=threads;
+		init_search_context(&ctx);
+		if (initialize_search(&ctx, initial_value, target_value, method)==0)
+			solution_node=search(&ctx);
+		if (solution_node!=NULL)
+			extract_solution(&ctx, solution_node);
+		end_search(&ctx);
+
+		if (solution_node==NULL)
+		{
+			printf("%3d threads: no solution\n",threads);
+			err=-1;
+		}
+		else
+		{
+			int g=ctx.solution_length>0 ? ctx.solution[ctx.solution_length-1].g : 0;
+			if (threads==1)
+			{
+				time1=ctx.t2-ctx.t1;
+				cpu1=ctx.critical_time;
+				cost=g;
+			}
+			printf("%3d threads: %f secs, speedup %.2f, processor time %f secs, %ld nodes expanded, cost %d%s\n",
+				threads, ctx.t2-ctx.t1, ctx.t2>ctx.t1 ? time1/(ctx.t2-ctx.t1) : 0.0, ctx.stats.cpu_time,
+				ctx.expanded_nodes, g, g==cost ? "" : " (DIFFERENT COST)");
+			if (method==pbreadth)
+				printf("             critical time %f secs, speedup with a processor per thread %.2f\n",
+					ctx.critical_time, ctx.critical_time>0 ? cpu1/ctx.critical_time : 0.0);
+			if (g!=cost)
+				err=-1;
+		}
+		free_search_context(&ctx);
+		if (threads>=max_threads)
+			break;
+	}
+	return err;
+}
+
+#define BENCH_SEED	2023	// The default seed of the corpus of the benchmark
+#define BENCH_CASES	6	// Cases of each kind in the corpus
+#define BENCH_REPEATS	3	// Runs of each case; the fastest one is kept
+#define BENCH_TIME_LIMIT	5	// Default time limit of a run of the benchmark
+
+double bench_tolerance=1.5;		// Slowdown of a run over the baseline that is flagged
+
+// The result of a run of the benchmark.
+struct bench_result
+{
+	int method;
+	int frontier;			// The frontier of best and astar
+	int initial_value;
+	int target_value;
+	int status;			// 1 --> solved, 0 --> no solution, -1 --> timeout, -2 --> error
+	int steps;
+	int cost;
+	long expanded;
+	double time;
+	long peak_rss;			// Peak resident memory in KB, -1 if it is not known
+};
+
+// A small generator of pseudo-random numbers (xorshift64*), so that the corpus is the
+// same with every C library.
+unsigned long long bench_random(unsigned long long *state)
+{
+	*state^=*state>>12;
+	*state^=*state<<25;
+	*state^=*state>>27;
+	return *state*2685821657736338717ULL;
+}
+
+// Returns a pseudo-random number from low to high.
+int bench_between(unsigned long long *state, int low, int high)
+{
+	return low+(int) (bench_random(state) % (unsigned long long) (high-low+1));
+}
+
+// This function creates the corpus of the benchmark from a seed: BENCH_CASES pairs of
+// small values, of medium values, of values near the 10^9 bound, and of values that
+// are reached with square and root.
+// Output:
+//		The number of pairs written to initial_values and target_values.
+int bench_corpus(unsigned long long seed, int *initial_values, int *target_values)
+{
+	unsigned long long state=seed*0x9E3779B97F4A7C15ULL+1;
+	int i, n=0, base;
+
+	for (i=0;i<BENCH_CASES;i++,n++)
+	{
+		initial_values[n]=bench_between(&state, 0, 100);
+		target_values[n]=bench_between(&state, 1, 100);
+	}
+	for (i=0;i<BENCH_CASES;i++,n++)
+	{
+		initial_values[n]=bench_between(&state, 0, 100000);
+		target_values[n]=bench_between(&state, 1, 100000);
+	}
+	for (i=0;i<BENCH_CASES;i++,n++)
+	{
+		initial_values[n]=bench_between(&state, MAX_VALUE-1000000, MAX_VALUE);
+		if (i%2==0)
+			target_values[n]=initial_values[n]-bench_between(&state, 1, 1000);
+		else
+			target_values[n]=initial_values[n]/2+bench_between(&state, -500, 500);
+	}
+	for (i=0;i<BENCH_CASES;i++,n++)
+	{
+		base=bench_between(&state, 2, 31622);
+		if (i%2==0)
+		{
+			initial_values[n]=base;
+			target_values[n]=base*base+bench_between(&state, -50, 50);
+		}
+		else
+		{
+			initial_values[n]=base*base+bench_between(&state, -50, 50);
+			target_values[n]=base;
+		}
+	}
+	return n;
+}
+
+// The runs of each case of the benchmark: every method with the frontier of --frontier,
+// and then best and astar with each of the two other frontiers, to compare them.
+#define BENCH_RUNS	(portfolio+4)
+
+// This function gives the method and the frontier of a run of the benchmark.
+void bench_variant(int run, int *method, int *frontier)
+{
+	static const int frontiers[3]={FRONTIER_HEAP, FRONTIER_LIST, FRONTIER_BUCKET};
+	int i, k;
+
+	if (run<portfolio)
+	{
+		*method=run+1;
+		*frontier=frontier_kind;
+		return;
+	}
+	*method = (run-portfolio)%2==0 ? best : astar;
+	k=(run-portfolio)/2;
+	for (i=0; frontiers[i]==frontier_kind || k-->0; i++)
+		;
+	*frontier=frontiers[i];
+}
+
+// Returns the name of a run in the results: the method, followed by its frontier
+// (e.g. astar/bucket) for best and astar when it is not the heap.
+const char *bench_name(struct bench_result *result)
+{
+	static char name[32];
+
+	if ((result->method==best || result->method==astar) && result->frontier!=FRONTIER_HEAP)
+		sprintf(name,"%s/%s",method_name(result->method),frontier_name(result->frontier));
+	else
+		strcpy(name,method_name(result->method));
+	return name;
+}
+
+// This function solves a case of the benchmark and fills its result (but the peak memory).
+void bench_solve(struct bench_result *result)
+{
+	struct search_context ctx;
+	struct tree_node *solution_node=NULL;
+	int saved_frontier=frontier_kind;
+
+	frontier_kind=result->frontier;
+	init_search_context(&ctx);
+	if (initialize_search(&ctx, result->initial_value, result->target_value, result->method)==0)
+		solution_node=search(&ctx);
+	if (solution_node!=NULL)
+		extract_solution(&ctx, solution_node);
+	end_search(&ctx);
+
+	result->time=ctx.t2-ctx.t1;
+	result->expanded=ctx.expanded_nodes;
+	if (solution_node!=NULL)
+	{
+		result->status=1;
+		result->steps=ctx.solution_length;
+		result->cost=ctx.solution_length>0 ? ctx.solution[ctx.solution_length-1].g : 0;
+	}
+	else
+		result->status = ctx.stats.stopped==STOP_TIME ? -1 : 0;
+	free_search_context(&ctx);
+	frontier_kind=saved_frontier;
+}
+
+// This function runs a case of the benchmark. On Linux and the other POSIX systems the
+// case is solved in a child process, so that the peak resident memory of the process
+// is the one of the case alone; elsewhere it is solved here and its memory is not known.
+void bench_run(struct bench_result *result)
+{
+#ifdef _WIN32
+	bench_solve(result);
+	result->peak_rss=-1;
+#else
+	int fd[2], status;
+	struct rusage usage;
+	pid_t pid;
+
+	result->status=-2;
+	result->peak_rss=-1;
+	if (pipe(fd)<0)
+		return;
+	fflush(stdout);
+	pid=fork();
+	if (pid<0)
+	{
+		close(fd[0]);
+		close(fd[1]);
+		return;
+	}
+	if (pid==0)
+	{
+		close(fd[0]);
+		if (freopen("/dev/null","w",stdout)==NULL)
+			_exit(1);
+		bench_solve(result);
+		if (write(fd[1], result, sizeof(struct bench_result))!=sizeof(struct bench_result))
+			_exit(1);
+		_exit(0);
+	}
+	close(fd[1]);
+	if (read(fd[0], result, sizeof(struct bench_result))!=sizeof(struct bench_result))
+		result->status=-2;	// The child has failed, e.g. out of memory
+	close(fd[0]);
+	if (wait4(pid, &status, 0, &usage)==pid)
+		result->peak_rss=usage.ru_maxrss;
+#endif
+}
+
+// Returns the name of the status of a run.
+const char *bench_status(int status)
+{
+	switch (status)
+	{
+		case 1:		return "solved";
+		case 0:		return "unsolved";
+		case -1:	return "timeout";
+		default:	return "error";
+	}
+}
+
+// This function reads the results of a previous run of the benchmark.
+// Output:
+//		The number of results, 0 if the file cannot be read.
+int bench_read_baseline(char* filename, struct bench_result *results, int capacity)
+{
+	char line[256], name[32], status[32], *slash;
+	double rate;
+	int n=0;
+	FILE *fin=fopen(filename,"r");
+
+	if (fin==NULL)
+		return 0;
+	while (n<capacity && fgets(line,sizeof(line),fin)!=NULL)
+	{
+		struct bench_result *result=&results[n];
+		if (line[0]=='#' || sscanf(line,"%31s %d %d %31s %d %d %ld %lf %lf %ld",name,&result->initial_value,
+			&result->target_value,status,&result->steps,&result->cost,&result->expanded,&result->time,
+			&rate,&result->peak_rss)!=10)
+			continue;
+		result->frontier=FRONTIER_HEAP;
+		slash=strchr(name,'/');
+		if (slash!=NULL)
+		{
+			*slash='\0';
+			result->frontier=get_frontier_kind(slash+1);
+		}
+		result->method=get_method(name);
+		for (result->status=1; result->status>=-2 && strcmp(status,bench_status(result->status))!=0; result->status--)
+			;
+		n++;
+	}
+	fclose(fin);
+	return n;
+}
+
+// This function compares a run with its baseline, and prints what has changed.
+// The baseline may come from a faster machine, so a case that the baseline solves in
+// more than the time limit divided by the tolerance may time out, and the solution of
+// arastar at the deadline may cost more and need more memory on another machine: these
+// changes are printed but are not regressions. Neither are the cost and the memory of
+// portfolio with --portfolio first, that depend on the method that wins the race.
+// Output:
+//		1 --> The run is a regression: it has stopped solving the case, found a more
+//		      expensive solution, or needs more time or memory than the tolerance allows
+//		0 --> No regression
+int bench_compare(FILE *fout, struct bench_result *run, struct bench_result *base)
+{
+	int regression=0;
+	int at_deadline = run->time>=time_limit || base->time>=time_limit;	// An anytime solution at the deadline
+	int raced = run->method==portfolio && portfolio_mode==PORTFOLIO_FIRST;	// The winner may change
+
+	if (run->status!=base->status)
+	{
+		fprintf(fout,"#   %s %d %d: %s, was %s\n",bench_name(run),run->initial_value,run->target_value,
+			bench_status(run->status),bench_status(base->status));
+		regression = base->status==1 && (run->status!=-1 || bench_tolerance*base->time<time_limit);
+	}
+	else if (run->status==1 && run->cost!=base->cost)
+	{
+		fprintf(fout,"#   %s %d %d: cost %d, was %d\n",bench_name(run),run->initial_value,run->target_value,
+			run->cost,base->cost);
+		regression = run->cost>base->cost && !at_deadline && !raced;
+	}
+	if (run->status==1 && base->status==1 && run->time>bench_tolerance*base->time && run->time-base->time>0.01)
+	{
+		fprintf(fout,"#   %s %d %d: %f secs, was %f secs\n",bench_name(run),run->initial_value,
+			run->target_value,run->time,base->time);
+		regression=1;
+	}
+	if (run->status==1 && base->status==1 && run->peak_rss>=0 && base->peak_rss>=0 &&
+		run->peak_rss>bench_tolerance*base->peak_rss &&
+		run->peak_rss-base->peak_rss>1024)
+	{
+		fprintf(fout,"#   %s %d %d: peak memory %ld KB, was %ld KB\n",bench_name(run),run->initial_value,
+			run->target_value,run->peak_rss,base->peak_rss);
+		regression = !at_deadline && !raced;
+	}
+	return regression;
+}
+
+// This function runs the benchmark: every method (and best and astar with every frontier,
+// see bench_variant) solves every case of the corpus of the seed, BENCH_REPEATS times (once if it does not solve it), and the fastest run is kept.
+// The results are written to the results file, with one line per method and case, and
+// compared with the results of a previous run (the baseline), if any.
+// Inputs:
+//		char* baseline_file	: The results of a previous run, or - for none
+//		char* results_file	: The file where the results are written, or - for the standard output
+// Output:
+//		0 --> No regression
+//		1 --> Some runs are regressions
+//		-1 --> File or memory problem
+int benchmark(unsigned long long seed, char* baseline_file, char* results_file)
+{
+	int initial_values[4*BENCH_CASES], target_values[4*BENCH_CASES];
+	int count=bench_corpus(seed, initial_values, target_values);
+	int baseline_count=0, variant, method, frontier, i, j, k, regressions=0, compared=0;
+	struct bench_result *baseline=NULL;
+	FILE *fout;
+
+	if (strcmp(baseline_file,"-")!=0)
+	{
+		baseline=(struct bench_result*) malloc(BENCH_RUNS*count*sizeof(struct bench_result));
+		if (baseline==NULL)
+			return -1;
+		baseline_count=bench_read_baseline(baseline_file, baseline, BENCH_RUNS*count);
+		if (baseline_count==0)
+			printf("No results in the baseline %s.\n",baseline_file);
+	}
+	fout = strcmp(results_file,"-")==0 ? stdout : fopen(results_file,"w");
+	if (fout==NULL)
+	{
+		printf("Cannot open the results file %s.\n",results_file);
+		free(baseline);
+		return -1;
+	}
+
+	fprintf(fout,"# seed %llu, time limit %.0f secs, best of %d runs\n",seed,time_limit,BENCH_REPEATS);
+	fprintf(fout,"# method\tinitial\ttarget\tstatus\tsteps\tcost\texpanded\tsecs\tnodes/sec\tpeak_rss_kb\n");
+	for (variant=0;variant<BENCH_RUNS;variant++)
+		for (i=0;i<count;i++)
+		{
+			struct bench_result fastest;
+
+			bench_variant(variant, &method, &frontier);
+			for (k=0;k<BENCH_REPEATS;k++)
+			{
+				struct bench_result run;
+				memset(&run, 0, sizeof(run));
+				run.method=method;
+				run.frontier=frontier;
+				run.initial_value=initial_values[i];
+				run.target_value=target_values[i];
+				bench_run(&run);
+				if (k==0 || run.time<fastest.time)
+					fastest=run;
+				if (run.status!=1)
+					break;
+			}
+			fprintf(fout,"%s\t%d\t%d\t%s\t%d\t%d\t%ld\t%f\t%.0f\t%ld\n",bench_name(&fastest),
+				fastest.initial_value,fastest.target_value,bench_status(fastest.status),fastest.steps,fastest.cost,
+				fastest.expanded,fastest.time,fastest.time>0 ? fastest.expanded/fastest.time : 0.0,fastest.peak_rss);
+			fflush(fout);
+
+			for (j=0;j<baseline_count;j++)
+				if (baseline[j].method==method && baseline[j].frontier==frontier &&
+					baseline[j].initial_value==fastest.initial_value &&
+					baseline[j].target_value==fastest.target_value)
+				{
+					compared++;
+					regressions+=bench_compare(fout, &fastest, &baseline[j]);
+					break;
+				}
+		}
+
+	if (baseline_count>0)
+		fprintf(fout,"# %d runs compared with %s, %d regressions\n",compared,baseline_file,regressions);
+	if (fout!=stdout)
+	{
+		fclose(fout);
+		if (baseline_count>0)
+			printf("%d runs compared with %s, %d regressions\n",compared,baseline_file,regressions);
+	}
+	free(baseline);
+	return regressions>0 ? 1 : 0;
+}
+
+// A query of the batch mode, and its result once it has been solved.
+struct batch_query
+{
+	char line[256];			// The query as it was read
+	int method;			// The search algorithm, -1 if the query is invalid
+	int initial_value;
+	int target_value;
+
+	int done;			// 1 when the query has been solved
+	int found;			// 1 if a solution has been found
+	double time;			// Time spent on the query
+	int solution_length;		// The solution, as returned by extract_solution
+	struct tree_node *solution;
+	struct tree_node solution_root;
+	struct search_stats stats;	// The counters of the search
+};
+
+// The queries of the batch mode, shared by the worker threads. The workers take the
+// next query to solve from next_query, and the main thread writes the results in
+// the order of the queries as they become done.
+struct batch
+{
+	struct batch_query *queries;
+	int count;			// Number of queries
+	int next_query;			// The first query not taken by a worker
+	mutex_t lock;			// Protects next_query and the done flags
+	cond_t query_done;		// Signalled whenever a query is done
+};
+
+// This function solves a query in the given search context, and moves the solution
+// from the context into the query.
+void solve_query(struct search_context *ctx, struct batch_query *query)
+{
+	struct tree_node *solution_node=NULL;
+
+	if (initialize_search(ctx, query->initial_value, query->target_value, query->method)==0)
+		solution_node = search(ctx);
+	if (solution_node!=NULL)
+		extract_solution(ctx, solution_node);
+	end_search(ctx);
+
+	query->time=ctx->t2-ctx->t1;
+	query->stats=ctx->stats;
+	query->found = solution_node!=NULL;
+	if (query->found)
+	{
+		query->solution_length=ctx->solution_length;
+		query->solution=ctx->solution;
+		query->solution_root=ctx->solution_root;
+		if (query->solution_length>0)
+			query->solution[0].parent=&query->solution_root;
+		ctx->solution=NULL;
+		ctx->solution_length=0;
+	}
+}
+
+// The worker thread of the batch mode. Each worker has its own search context and
+// solves queries until there are no more queries to take.
+void batch_worker(void *argument)
+{
+	struct batch *b=(struct batch*) argument;
+	struct search_context ctx;
+	int i;
+
+	init_search_context(&ctx);
+	while (1)
+	{
+		mutex_lock(&b->lock);
+		i=b->next_query++;
+		mutex_unlock(&b->lock);
+		if (i>=b->count)
+			break;
+
+		solve_query(&ctx, &b->queries[i]);
+
+		mutex_lock(&b->lock);
+		b->queries[i].done=1;
+		cond_broadcast(&b->query_done);
+		mutex_unlock(&b->lock);
+	}
+	free_search_context(&ctx);
+}
+
+// This function reads a query <method> <initial number> <target value> from a line.
+// The query is invalid (method -1, and done) if the line has another form.
+void parse_query(char *line, struct batch_query *query)
+{
+	char method_name[32];
+	long value1, value2;
+
+	memset(query, 0, sizeof(struct batch_query));
+	line[strcspn(line,"\r\n")]='\0';
+	strncpy(query->line, line, sizeof(query->line)-1);
+	if (sscanf(line,"%31s %ld %ld",method_name,&value1,&value2)!=3 ||
+		(query->method=get_method(method_name))<0 || value1<0 || value2==0 ||
+		value1>MAX_VALUE || value2>MAX_VALUE)
+	{
+		query->method=-1;
+		query->done=1;
+		return;
+	}
+	query->initial_value=value1;
+	query->target_value=value2;
+}
+
+// This function reads all the queries of a query file. Empty lines and lines starting
+// with # are skipped, and invalid queries are kept (with method -1) to be reported.
+// Output:
+//		The number of queries, or -1 in case of memory problem.
+int read_queries(FILE *fin, struct batch_query **queries)
+{
+	char line[256], method_name[32];
+	int count=0, capacity=0;
+
+	*queries=NULL;
+	while (fgets(line,sizeof(line),fin)!=NULL)
+	{
+		if (sscanf(line,"%31s",method_name)!=1 || method_name[0]=='#')
+			continue;
+		if (count==capacity)
+		{
+			int new_capacity = capacity==0 ? 256 : 2*capacity;
+			struct batch_query *new_queries=(struct batch_query*)
+					realloc(*queries, new_capacity*sizeof(struct batch_query));
+			if (new_queries==NULL)
+			{
+				free(*queries);
+				*queries=NULL;
+				return -1;
+			}
+			*queries=new_queries;
+			capacity=new_capacity;
+		}
+
+		parse_query(line, &(*queries)[count++]);
+	}
+	return count;
+}
+
+// This function solves a batch of queries, one per line of the query file, in the form
+// <method> <initial number> <target value>
+// The queries are solved by thread_count worker threads, each one with its own search
+// context. The solutions are streamed to the output file in the order of the queries,
+// each one preceded by a line with the query and the time spent on it.
+// Inputs:
+//		char* query_file	: The file with the queries, or - for the standard input.
+//		char* output_file	: The file where the solutions are written, or - for the standard output.
+// Output:
+//		0 --> All the queries have been solved
+//		EXIT_TIME, EXIT_NODES or EXIT_MEMORY --> The budget of the first query stopped (see exit_status)
+//		-1 --> The query or the output file cannot be opened, or memory problem
+int solve_batch(char* query_file, char* output_file)
+{
+	struct batch b;
+	thread_t *threads;
+	int i, started=0, solved=0, status=0, portfolios=0;
+	int wins[portfolio+1]={0};		// The portfolio queries won by each method, or by none
+	double batch_start, batch_end;
+	FILE *fin, *fout, *fsummary=stdout;
+
+	fin = strcmp(query_file,"-")==0 ? stdin : fopen(query_file,"r");
+	if (fin==NULL)
+	{
+		printf("Cannot open query file %s.\n",query_file);
+		return -1;
+	}
+	if (strcmp(output_file,"-")==0)
+	{
+		fout=stdout;
+		fsummary=stderr;
+	}
+	else
+		fout=fopen(output_file,"w");
+	if (fout==NULL)
+	{
+		printf("Cannot open output file to write solutions.\n");
+		if (fin!=stdin)
+			fclose(fin);
+		return -1;
+	}
+
+	batch_start=wall_clock();
+	b.count=read_queries(fin, &b.queries);
+	if (fin!=stdin)
+		fclose(fin);
+	threads=(thread_t*) malloc(thread_count*sizeof(thread_t));
+	if (b.count<0 || threads==NULL)
+	{
+		printf("Memory exhausted while reading the queries.\n");
+		free(threads);
+		free(b.queries);
+		if (fout!=stdout)
+			fclose(fout);
+		return -1;
+	}
+	b.next_query=0;
+	mutex_init(&b.lock);
+	cond_init(&b.query_done);
+
+	for (i=0;i<thread_count;i++)
+		if (thread_create(&threads[started], batch_worker, &b)==0)
+			started++;
+	if (started==0)
+		batch_worker(&b);	// No thread could be started, the queries are solved here
+
+	// Writing the results in the order of the queries
+	for (i=0;i<b.count;i++)
+	{
+		struct batch_query *query=&b.queries[i];
+
+		mutex_lock(&b.lock);
+		while (!query->done)
+			cond_wait(&b.query_done, &b.lock);
+		mutex_unlock(&b.lock);
+
+		if (query->method<0)
+		{
+			fprintf(fout,"query %d: invalid query: %s\n",i+1,query->line);
+			continue;
+		}
+		fprintf(fout,"query %d: %s (%f secs)\n",i+1,query->line,query->time);
+		if (query->found)
+		{
+			print_solution(fout, query->solution_length, query->solution);
+			solved++;
+		}
+		else
+			fprintf(fout,"No solution found.\n");
+		if (stats_text || query->stats.stopped)
+			print_stats(fout, &query->stats);
+		if (status==0)
+			status=exit_status(&query->stats);
+		if (query->method==portfolio)
+		{
+			portfolios++;
+			wins[query->stats.winner]++;
+		}
+		if (stats_json!=NULL)
+			write_stats_json(stats_json, i+1, query->method, query->initial_value, query->target_value,
+				query->found, query->solution_length, query->solution, &query->stats);
+		free(query->solution);
+	}
+	fflush(fout);
+
+	for (i=0;i<started;i++)
+		thread_join(threads[i]);
+	batch_end=wall_clock();
+
+	fprintf(fsummary,"%d queries, %d solved, in %f secs with %d threads",b.count,solved,batch_end-batch_start,started>0 ? started : 1);
+	if (batch_end>batch_start)
+		fprintf(fsummary," (%.1f queries/sec)",b.count/(batch_end-batch_start));
+	fprintf(fsummary,"\n");
+	if (portfolios>0)
+	{
+		fprintf(fsummary,"Portfolio wins:");
+		for (i=1;i<portfolio;i++)
+			if (wins[i]>0)
+				fprintf(fsummary," %s %d",method_name(i),wins[i]);
+		if (wins[0]>0)
+			fprintf(fsummary," none %d",wins[0]);
+		fprintf(fsummary,"\n");
+	}
+	if (cache.base!=NULL)
+		print_cache_stats(fsummary);
+
+	mutex_destroy(&b.lock);
+	cond_destroy(&b.query_done);
+	free(threads);
+	free(b.queries);
+	if (fout!=stdout)
+		fclose(fout);
+	return status;
+}
+
+// A target of the one-to-many search, with the node where its cheapest path ends.
+struct search_target
+{
+	char line[256];			// The target, as given in the target file
+	int target_value;		// -1 if the line is not a valid target
+	struct tree_node *node;		// The node of the target, NULL until it is settled
+};
+
+// This function implements the one-to-many search: a uniform-cost search from the initial
+// value, that settles the values in increasing order of cost, as each side of bidirectional
+// does. A value is settled when its node is extracted from the heap, and its cost is then the
+// optimal one, so the node of each target is recorded when the target is settled. The search
+// stops when every target has been settled, or when a budget is exhausted.
+// Inputs:
+//		struct search_target *targets	: The targets, whose nodes are filled
+//		struct value_set *pending	: The values of the targets that are not settled yet
+// Output:
+//		The number of target values that have not been settled, or -1 in case of memory problem.
+long search_targets(struct search_context *ctx, struct search_target *targets, int count, struct value_set *pending)
+{
+	struct tree_node *root, *current_node, *child;
+	struct closed_entry *entry;
+	struct move moves[MAX_MOVES];
+	long remaining=pending->count;
+	int i, n;
+
+	root=alloc_tree_node(ctx);
+	if (root==NULL)
+		return -1;
+	memset(root, 0, sizeof(struct tree_node));
+	root->node_value=ctx->initial_value;
+	root->operation=-1;
+	entry=add_closed(&ctx->closed, root->node_value);
+	if (entry==NULL || heap_push(&ctx->frontier_heap, root)<0)
+		return -1;
+	entry->g=0;
+	entry->n=root;
+	ctx->root=root;
+	note_frontier_size(ctx, 1);
+
+	while (ctx->frontier_heap.size>0 && remaining>0)
+	{
+		if (over_budget(ctx))
+		{
+			print_stop(ctx);
+			break;
+		}
+		current_node=ctx->frontier_heap.entries[0].n;
+		heap_pop(&ctx->frontier_heap);
+		if (lookup_closed(&ctx->closed, current_node->node_value)!=current_node)
+			continue;	// A cheaper node with the same value has been found later
+
+		// The value is settled
+		if (has_value(pending, current_node->node_value))
+		{
+			for (i=0;i<count;i++)
+				if (targets[i].target_value==current_node->node_value)
+					targets[i].node=current_node;
+			if (--remaining==0)
+				break;
+		}
+		ctx->expanded_nodes++;
+
+		n=successors(current_node->node_value, moves);
+		for (i=0;i<n;i++)
+		{
+			int g=current_node->g+moves[i].cost;
+
+			if (!cost_fits(current_node->g, moves[i].cost))
+				continue;
+			entry=add_closed(&ctx->closed, moves[i].node_value);
+			if (entry==NULL)
+				return -1;
+			count_child(ctx, moves[i].operation, entry->n!=NULL && entry->g<=g);
+			if (entry->n!=NULL && entry->g<=g)
+				continue;
+
+			child=alloc_tree_node(ctx);
+			if (child==NULL)
+				return -1;
+			child->node_value=moves[i].node_value;
+			child->operation=moves[i].operation;
+			child->parent=current_node;
+			child->node_depth=current_node->node_depth+1;
+			child->g=g;
+			child->h=0;
+			child->f=g;
+			entry->g=g;
+			entry->n=child;
+			if (heap_push(&ctx->frontier_heap, child)<0)
+				return -1;
+		}
+		note_frontier_size(ctx, ctx->frontier_heap.size);
+	}
+	return remaining;
+}
+
+// This function solves the paths from one initial value to many targets, one per line of the
+// target file, with one search (see search_targets). The solution of each target is written
+// to the output file in the order of the target file, in the form of write_solution_to_file,
+// preceded by a line with the target.
+// Inputs:
+//		int initial_value	: The value of the root
+//		char* target_file	: The file with the targets, or - for the standard input.
+//		char* output_file	: The file where the solutions are written, or - for the standard output.
+// Output:
+//		0 --> Every target has been solved
+//		EXIT_TIME, EXIT_NODES or EXIT_MEMORY --> The budget that has stopped the search (see exit_status)
+//		-1 --> The target or the output file cannot be opened, or memory problem
+int solve_targets(int initial_value, char* target_file, char* output_file)
+{
+	struct search_context ctx;
+	struct search_target *targets=NULL;
+	struct value_set pending;
+	FILE *fin, *fout;
+	char line[256], *p;
+	int i, count=0, capacity=0, solved=0, status, err=0;
+	long remaining;
+
+	fin = strcmp(target_file,"-")==0 ? stdin : fopen(target_file,"r");
+	if (fin==NULL)
+	{
+		printf("Cannot open the target file %s.\n",target_file);
+		return -1;
+	}
+	memset(&pending, 0, sizeof(pending));
+	while (fgets(line,sizeof(line),fin)!=NULL)
+	{
+		struct search_target *target;
+		long value;
+
+		line[strcspn(line,"\r\n")]='\0';
+		if (line[0]=='\0' || line[0]=='#')
+			continue;
+		if (count==capacity)
+		{
+			int new_capacity = capacity==0 ? 256 : 2*capacity;
+			struct search_target *new_targets=(struct search_target*)
+					realloc(targets, new_capacity*sizeof(struct search_target));
+			if (new_targets==NULL)
+			{
+				err=-1;
+				break;
+			}
+			targets=new_targets;
+			capacity=new_capacity;
+		}
+		target=&targets[count++];
+		strcpy(target->line, line);
+		target->node=NULL;
+		value=strtol(line, &p, 10);
+		target->target_value = p!=line && *p=='\0' && value>0 && value<=MAX_VALUE ? (int) value : -1;
+		if (target->target_value>=0 && add_value(&pending, target->target_value)<0)
+		{
+			err=-1;
+			break;
+		}
+	}
+	if (fin!=stdin)
+		fclose(fin);
+	if (err<0)
+	{
+		printf("Memory exhausted while reading the targets.\n");
+		free(pending.values);
+		free(targets);
+		return -1;
+	}
+
+	init_search_context(&ctx);
+	ctx.initial_value=initial_value;
+	ctx.target_value=initial_value;
+	ctx.budget_countdown=1;
+	ctx.running=1;
+	ctx.c1=cpu_clock();
+	ctx.t1=wall_clock();
+	remaining=search_targets(&ctx, targets, count, &pending);
+	stop_clocks(&ctx);
+	if (remaining<0)
+		printf("Memory exhausted while creating new frontier node. Search is terminated...\n");
+
+	fout = strcmp(output_file,"-")==0 ? stdout : fopen(output_file,"w");
+	if (fout==NULL)
+		printf("Cannot open output file to write solutions.\n");
+	for (i=0; fout!=NULL && i<count; i++)
+	{
+		if (targets[i].target_value<0)
+		{
+			fprintf(fout,"target %d: invalid target: %s\n",i+1,targets[i].line);
+			continue;
+		}
+		fprintf(fout,"target %d: %s\n",i+1,targets[i].line);
+		if (targets[i].node!=NULL)
+		{
+			extract_solution(&ctx, targets[i].node);
+			print_solution(fout, ctx.solution_length, ctx.solution);
+			solved++;
+		}
+		else
+			fprintf(fout,"No solution found.\n");
+	}
+	end_search(&ctx);
+
+	printf("%d targets, %d solved, in %f secs (%ld nodes expanded)\n",count,solved,ctx.t2-ctx.t1,ctx.expanded_nodes);
+	if (stats_text || ctx.stats.stopped)
+		print_stats(stdout, &ctx.stats);
+	status = fout==NULL || remaining<0 ? -1 : exit_status(&ctx.stats);
+	if (fout!=NULL && fout!=stdout)
+		fclose(fout);
+	free_search_context(&ctx);
+	free(pending.values);
+	free(targets);
+	return status;
+}
+
+#ifndef _WIN32
+
+#define SERVER_QUEUE	256	// Accepted connections that wait for a worker of the server
+
+// The connections accepted by the server, waiting for a worker. Each worker has its own
+// search context and serves one connection at a time, answering its requests in order.
+struct server
+{
+	int connections[SERVER_QUEUE];	// A circular queue of sockets
+	int first;
+	int count;
+	int *active;			// The connection served by each worker, -1 if none
+	int workers;			// Number of workers that have taken their index in active
+	int stopping;			// 1 when the server stops: the workers serve the queue and end
+	mutex_t lock;			// Protects the queue, active and stopping
+	cond_t changed;			// Signalled when a connection is added or taken, or the server stops
+	long requests;			// Number of requests answered
+};
+
+volatile sig_atomic_t server_stopping=0;	// Set by SIGINT and SIGTERM in the server mode
+
+// The handler of SIGINT and SIGTERM in the server mode.
+void stop_server(int signal_number)
+{
+	(void) signal_number;
+	server_stopping=1;
+}
+
+// This function opens a connection to the server.
+// Output:
+//		The socket, or -1 if the server cannot be reached
+int connect_server(char *path)
+{
+	struct sockaddr_un address;
+	int fd;
+
+	if (strlen(path)>=sizeof(address.sun_path))
+		return -1;
+	fd=socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd<0)
+		return -1;
+	memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	strcpy(address.sun_path, path);
+	if (connect(fd, (struct sockaddr*) &address, sizeof(address))<0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// This function opens the two streams of a connection: one to read and one to write.
+// Output:
+//		0 --> The streams are open (and own the socket)
+//		-1 --> Memory problem, the socket is closed
+int open_connection(int fd, FILE **fin, FILE **fout)
+{
+	int out_fd=dup(fd);
+
+	*fin=fdopen(fd, "r");
+	*fout = out_fd<0 ? NULL : fdopen(out_fd, "w");
+	if (*fin!=NULL && *fout!=NULL)
+		return 0;
+	if (*fin!=NULL)
+		fclose(*fin);
+	else
+		close(fd);
+	if (*fout!=NULL)
+		fclose(*fout);
+	else if (out_fd>=0)
+		close(out_fd);
+	return -1;
+}
+
+// This function writes the reply to a request of the server. The text form is the solution
+// as written by write_solution_to_file, or "No solution found.", or "Invalid query: <query>".
+// The binary form is the number of moves (-1 without solution, -2 for an invalid query)
+// and the cost, as two 32-bit integers in the byte order of the host, followed by the
+// operation of each move in one byte.
+void write_reply(FILE *fout, struct batch_query *query, int binary)
+{
+	int header[2], i;
+
+	if (!binary)
+	{
+		if (query->method<0)
+			fprintf(fout,"Invalid query: %s\n",query->line);
+		else if (query->found)
+			print_solution(fout, query->solution_length, query->solution);
+		else
+			fprintf(fout,"No solution found.\n");
+		return;
+	}
+	header[0] = query->method<0 ? -2 : query->found ? query->solution_length : -1;
+	header[1] = query->found && query->solution_length>0 ? query->solution[query->solution_length-1].g : 0;
+	fwrite(header, sizeof(int), 2, fout);
+	for (i=0; query->found && i<query->solution_length; i++)
+		putc(query->solution[i].operation, fout);
+}
+
+// This function reads the reply to a request (see write_reply), and writes it to fout in
+// the text form, if fout is not NULL. The values and the costs of a binary reply are
+// rebuilt from the initial value and the operations.
+// Output:
+//		1 --> A solution has been read
+//		0 --> The reply is "No solution found." or "Invalid query"
+//		-1 --> The connection has been closed, or the reply is not valid
+int read_reply(FILE *fin, int binary, int initial_value, FILE *fout)
+{
+	struct move moves[MAX_MOVES];
+	struct tree_node root, *solution;
+	char line[256];
+	int header[2], i, j, n;
+
+	if (!binary)
+	{
+		if (fgets(line,sizeof(line),fin)==NULL)
+			return -1;
+		if (fout!=NULL)
+			fputs(line, fout);
+		if (sscanf(line,"%d, %*d",&n)!=1)
+			return 0;
+		for (i=0;i<n;i++)
+		{
+			if (fgets(line,sizeof(line),fin)==NULL)
+				return -1;
+			if (fout!=NULL)
+				fputs(line, fout);
+		}
+		return 1;
+	}
+
+	if (fread(header, sizeof(int), 2, fin)!=2)
+		return -1;
+	if (header[0]<0)
+	{
+		if (fout!=NULL)
+			fprintf(fout, header[0]==-2 ? "Invalid query\n" : "No solution found.\n");
+		return 0;
+	}
+	n=header[0];
+	solution=(struct tree_node*) malloc((n>0 ? n : 1)*sizeof(struct tree_node));
+	if (solution==NULL)
+		return -1;
+	memset(&root, 0, sizeof(root));
+	root.node_value=initial_value;
+	for (i=0;i<n;i++)
+	{
+		struct tree_node *parent = i>0 ? &solution[i-1] : &root;
+		int operation=getc(fin), count = operation==EOF ? 0 : successors(parent->node_value, moves);
+
+		for (j=0; j<count && moves[j].operation!=operation; j++)
+			;
+		if (j==count)
+		{
+			free(solution);
+			return -1;
+		}
+		memset(&solution[i], 0, sizeof(struct tree_node));
+		solution[i].parent=parent;
+		solution[i].operation=operation;
+		solution[i].node_value=moves[j].node_value;
+		solution[i].g=parent->g+moves[j].cost;
+	}
+	if (fout!=NULL)
+		print_solution(fout, n, solution);
+	free(solution);
+	return 1;
+}
+
+// This function answers the requests of a connection until the client closes it or sends
+// quit. A request is a query <method> <initial number> <target value>, followed by binary
+// for the binary reply. The client may send its requests without waiting for the replies.
+// When the server stops, the requests already sent are answered and the connection is closed.
+void serve_connection(struct server *server, struct search_context *ctx, int fd, int *active)
+{
+	struct batch_query query;
+	char line[256], word[32];
+	FILE *fin, *fout;
+	int binary;
+
+	if (open_connection(fd, &fin, &fout)<0)
+	{
+		mutex_lock(&server->lock);
+		*active=-1;
+		mutex_unlock(&server->lock);
+		return;
+	}
+	while (fgets(line,sizeof(line),fin)!=NULL)
+	{
+		if (sscanf(line,"%31s",word)!=1 || word[0]=='#')
+			continue;
+		if (strcmp(word,"quit")==0)
+			break;
+		binary = sscanf(line,"%*s %*s %*s %31s",word)==1 && strcmp(word,"binary")==0;
+		parse_query(line, &query);
+		if (query.method>=0)
+			solve_query(ctx, &query);
+		write_reply(fout, &query, binary);
+		free(query.solution);
+		if (fflush(fout)!=0)
+			break;		// The client has gone
+		atomic_add_long(&server->requests, 1);
+	}
+	// The socket is no longer active before it is closed, so that stop_connections never
+	// shuts down a socket number that has been given to another connection
+	mutex_lock(&server->lock);
+	*active=-1;
+	mutex_unlock(&server->lock);
+	fclose(fin);
+	fclose(fout);
+}
+
+// The worker thread of the server. It serves the connections of the queue, one at a time,
+// until the server stops and the queue is empty.
+void server_worker(void *argument)
+{
+	struct server *server=(struct server*) argument;
+	struct search_context ctx;
+	int fd, index;
+
+	init_search_context(&ctx);
+	mutex_lock(&server->lock);
+	index=server->workers++;
+	mutex_unlock(&server->lock);
+	while (1)
+	{
+		mutex_lock(&server->lock);
+		while (server->count==0 && !server->stopping)
+			cond_wait(&server->changed, &server->lock);
+		if (server->count==0)
+		{
+			mutex_unlock(&server->lock);
+			break;
+		}
+		fd=server->connections[server->first];
+		server->first=(server->first+1)%SERVER_QUEUE;
+		server->count--;
+		server->active[index]=fd;
+		if (server->stopping)
+			shutdown(fd, SHUT_RD);	// The requests already sent are answered, and no other one is read
+		cond_broadcast(&server->changed);
+		mutex_unlock(&server->lock);
+
+		serve_connection(server, &ctx, fd, &server->active[index]);
+	}
+	free_search_context(&ctx);
+}
+
+// This function adds an accepted connection to the queue of the server, waiting for a
+// worker to take one if the queue is full.
+void queue_connection(struct server *server, int client)
+{
+	mutex_lock(&server->lock);
+	while (server->count==SERVER_QUEUE)
+		cond_wait(&server->changed, &server->lock);
+	server->connections[(server->first+server->count)%SERVER_QUEUE]=client;
+	server->count++;
+	cond_broadcast(&server->changed);
+	mutex_unlock(&server->lock);
+}
+
+// This function stops the workers of the server. The connections that are served are shut
+// down for reading, so that their workers answer the requests already sent and close them;
+// the workers then serve the connections left in the queue in the same way, and end.
+void stop_connections(struct server *server)
+{
+	int i;
+
+	mutex_lock(&server->lock);
+	server->stopping=1;
+	for (i=0;i<server->workers;i++)
+		if (server->active[i]>=0)
+			shutdown(server->active[i], SHUT_RD);
+	cond_broadcast(&server->changed);
+	mutex_unlock(&server->lock);
+}
+
+// This function runs the server: it listens on a Unix domain socket and serves the
+// connections with thread_count workers until SIGINT or SIGTERM. The table, the landmarks
+// and the cache given with the options stay mapped for all the requests. When it stops,
+// the connections waiting to be accepted or served, and the requests already sent on
+// them, are still answered.
+// Output:
+//		0 --> The server has been stopped
+//		-1 --> The socket cannot be created, or no worker can be started
+int serve(char *path)
+{
+	struct server server;
+	struct sockaddr_un address;
+	struct sigaction action;
+	thread_t *threads;
+	int fd, client, i, started=0;
+
+	if (strlen(path)>=sizeof(address.sun_path))
+	{
+		printf("The socket path %s is too long.\n",path);
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	strcpy(address.sun_path, path);
+	unlink(path);		// The socket of a previous server
+	fd=socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd<0 || bind(fd, (struct sockaddr*) &address, sizeof(address))<0 || listen(fd, SERVER_QUEUE)<0)
+	{
+		printf("Cannot listen on the socket %s.\n",path);
+		if (fd>=0)
+			close(fd);
+		return -1;
+	}
+
+	memset(&server, 0, sizeof(server));
+	server.active=(int*) malloc(thread_count*sizeof(int));
+	threads=(thread_t*) malloc(thread_count*sizeof(thread_t));
+	mutex_init(&server.lock);
+	cond_init(&server.changed);
+	for (i=0; i<thread_count && server.active!=NULL && threads!=NULL; i++)
+	{
+		server.active[i]=-1;
+		if (thread_create(&threads[started], server_worker, &server)==0)
+			started++;
+	}
+	if (started==0)
+	{
+		printf("Cannot start the workers of the server.\n");
+		close(fd);
+		unlink(path);
+		free(server.active);
+		free(threads);
+		return -1;
+	}
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler=stop_server;		// Without SA_RESTART, so that accept is interrupted
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);		// A client that has gone is noticed when its reply is written
+	printf("Listening on %s with %d workers\n",path,started);
+	fflush(stdout);
+
+	while (!server_stopping)
+	{
+		client=accept(fd, NULL, NULL);
+		if (client<0)
+		{
+			if (errno==EINTR || errno==ECONNABORTED)
+				continue;
+			printf("Cannot accept connections on %s.\n",path);
+			break;
+		}
+		queue_connection(&server, client);
+	}
+
+	// The connections that wait to be accepted are served too
+	unlink(path);
+	if (fcntl(fd, F_SETFL, O_NONBLOCK)==0)
+		while ((client=accept(fd, NULL, NULL))>=0)
+			queue_connection(&server, client);
+	close(fd);
+	stop_connections(&server);
+	for (i=0;i<started;i++)
+		thread_join(threads[i]);
+	mutex_destroy(&server.lock);
+	cond_destroy(&server.changed);
+	free(server.active);
+	free(threads);
+	printf("%ld requests answered\n",atomic_load_long(&server.requests));
+	if (cache.base!=NULL)
+		print_cache_stats(stdout);
+	return 0;
+}
+
+// The requests of the client mode. They are sent by a thread of their own while the
+// replies are read, so that neither side waits for the other.
+struct client_requests
+{
+	FILE *fout;
+	int fd;
+	struct batch_query *queries;
+	int count;
+};
+
+// The thread that sends the requests of the client mode.
+void send_requests(void *argument)
+{
+	struct client_requests *requests=(struct client_requests*) argument;
+	int i;
+
+	for (i=0;i<requests->count;i++)
+		fprintf(requests->fout,"%s%s\n",requests->queries[i].line,binary_replies ? " binary" : "");
+	fflush(requests->fout);
+	shutdown(requests->fd, SHUT_WR);
+}
+
+// This function runs the client: it sends all the queries of a query file to the server,
+// one request per query, and writes the replies in the form of the batch mode.
+// Inputs:
+//		char* query_file	: The file with the queries, or - for the standard input.
+//		char* output_file	: The file where the solutions are written, or - for the standard output.
+// Output:
+//		0 --> All the replies have been received
+//		-1 --> A file cannot be opened, the server cannot be reached or a reply is missing
+int run_client(char *path, char *query_file, char *output_file)
+{
+	struct client_requests requests;
+	struct batch_query *queries;
+	thread_t thread;
+	FILE *fin, *fout, *fsummary=stdout, *freplies;
+	int i, fd, count, solved=0, err=0, result, threaded;
+	double t1=wall_clock();
+
+	fin = strcmp(query_file,"-")==0 ? stdin : fopen(query_file,"r");
+	if (fin==NULL)
+	{
+		printf("Cannot open query file %s.\n",query_file);
+		return -1;
+	}
+	count=read_queries(fin, &queries);
+	if (fin!=stdin)
+		fclose(fin);
+	if (count<0)
+	{
+		printf("Memory exhausted while reading the queries.\n");
+		return -1;
+	}
+	if (strcmp(output_file,"-")==0)
+	{
+		fout=stdout;
+		fsummary=stderr;
+	}
+	else
+		fout=fopen(output_file,"w");
+	fd=connect_server(path);
+	if (fout==NULL || fd<0 || open_connection(fd, &freplies, &requests.fout)<0)
+	{
+		if (fout==NULL)
+			printf("Cannot open output file to write solutions.\n");
+		else
+			printf("Cannot connect to the server at %s.\n",path);
+		if (fout!=NULL && fout!=stdout)
+			fclose(fout);
+		if (fd>=0 && fout==NULL)
+			close(fd);
+		free(queries);
+		return -1;
+	}
+
+	requests.fd=fd;
+	requests.queries=queries;
+	requests.count=count;
+	threaded = thread_create(&thread, send_requests, &requests)==0;
+	if (!threaded)
+		send_requests(&requests);	// All the requests are sent first
+	for (i=0;i<count;i++)
+	{
+		fprintf(fout,"query %d: %s\n",i+1,queries[i].line);
+		result=read_reply(freplies, binary_replies, queries[i].initial_value, fout);
+		if (result<0)
+		{
+			printf("The server has closed the connection.\n");
+			err=-1;
+			break;
+		}
+		solved+=result;
+	}
+	if (threaded)
+		thread_join(thread);
+	fclose(requests.fout);
+	fclose(freplies);
+	fflush(fout);
+	if (fout!=stdout)
+		fclose(fout);
+	free(queries);
+
+	fprintf(fsummary,"%d queries, %d solved, in %f secs\n",count,solved,wall_clock()-t1);
+	return err;
+}
+
+// A connection of the load generator: it sends its requests one after the other, each one
+// when the reply to the previous one has been read, and measures the latency of each one.
+struct loadgen_connection
+{
+	char *path;
+	struct batch_query *queries;
+	int count;				// Number of queries
+	int first;				// The query sent first, so that the connections send different queries
+	long requests;			// Number of requests to send
+	long answered;			// Number of replies read
+	double *latencies;			// The latency of each request, in secs
+};
+
+// The thread of a connection of the load generator.
+void loadgen_worker(void *argument)
+{
+	struct loadgen_connection *connection=(struct loadgen_connection*) argument;
+	FILE *fin, *fout;
+	int fd=connect_server(connection->path);
+
+	if (fd<0 || open_connection(fd, &fin, &fout)<0)
+		return;
+	for (connection->answered=0; connection->answered<connection->requests; connection->answered++)
+	{
+		struct batch_query *query=&connection->queries[(connection->first+connection->answered)%connection->count];
+		double t1=wall_clock();
+
+		fprintf(fout,"%s%s\n",query->line,binary_replies ? " binary" : "");
+		if (fflush(fout)!=0 || read_reply(fin, binary_replies, query->initial_value, NULL)<0)
+			break;
+		connection->latencies[connection->answered]=wall_clock()-t1;
+	}
+	fclose(fin);
+	fclose(fout);
+}
+
+// Compares two latencies, for qsort.
+int compare_latencies(const void *a, const void *b)
+{
+	double x=*(const double*) a, y=*(const double*) b;
+	return x<y ? -1 : x>y;
+}
+
+// This function runs the load generator: the queries of a query file are sent to the
+// server over the given number of connections, in turn, until the given number of
+// requests have been answered. The throughput and the percentiles of the latency are printed.
+// Output:
+//		0 --> All the requests have been answered
+//		-1 --> The query file cannot be read, memory problem, or requests without reply
+int run_loadgen(char *path, char *query_file, long requests, int connections)
+{
+	struct loadgen_connection *connection;
+	struct batch_query *queries;
+	thread_t *threads;
+	double *latencies, t1, t2;
+	static const double percentiles[]={50, 90, 99, 99.9};
+	long answered=0;
+	int i, count, started=0;
+	FILE *fin;
+
+	fin = strcmp(query_file,"-")==0 ? stdin : fopen(query_file,"r");
+	if (fin==NULL)
+	{
+		printf("Cannot open query file %s.\n",query_file);
+		return -1;
+	}
+	count=read_queries(fin, &queries);
+	if (fin!=stdin)
+		fclose(fin);
+	latencies=(double*) malloc(requests*sizeof(double));
+	connection=(struct loadgen_connection*) calloc(connections, sizeof(struct loadgen_connection));
+	threads=(thread_t*) malloc(connections*sizeof(thread_t));
+	if (count<=0 || latencies==NULL || connection==NULL || threads==NULL)
+	{
+		printf(count==0 ? "No query in %s.\n" : "Memory exhausted while reading the queries.\n",query_file);
+		free(queries);
+		free(latencies);
+		free(connection);
+		free(threads);
+		return -1;
+	}
+
+	// The latencies of the connections follow each other in latencies
+	t1=wall_clock();
+	for (i=0;i<connections;i++)
+	{
+		connection[i].path=path;
+		connection[i].queries=queries;
+		connection[i].count=count;
+		connection[i].first=(int) ((long long) i*count/connections);
+		connection[i].requests=requests/connections+(i<requests%connections);
+		connection[i].latencies = i>0 ? connection[i-1].latencies+connection[i-1].requests : latencies;
+		if (thread_create(&threads[started], loadgen_worker, &connection[i])==0)
+			started++;
+		else
+			connection[i].requests=0;
+	}
+	for (i=0;i<started;i++)
+		thread_join(threads[i]);
+	t2=wall_clock();
+
+	// The latencies are gathered at the start of the table
+	for (i=0;i<connections;i++)
+	{
+		memmove(&latencies[answered], connection[i].latencies, connection[i].answered*sizeof(double));
+		answered+=connection[i].answered;
+	}
+	printf("%ld requests answered of %ld, on %d connections, in %f secs",answered,requests,started,t2-t1);
+	if (t2>t1)
+		printf(" (%.1f requests/sec)",answered/(t2-t1));
+	printf("\n");
+	if (answered>0)
+	{
+		double total=0;
+		qsort(latencies, answered, sizeof(double), compare_latencies);
+		for (i=0;i<answered;i++)
+			total+=latencies[i];
+		printf("Latency: mean %.3f ms",1000*total/answered);
+		for (i=0;i<(int) (sizeof(percentiles)/sizeof(percentiles[0]));i++)
+			printf(", p%g %.3f ms",percentiles[i],1000*latencies[(long) (percentiles[i]/100*(answered-1))]);
+		printf(", max %.3f ms\n",1000*latencies[answered-1]);
+	}
+
+	free(queries);
+	free(latencies);
+	free(connection);
+	free(threads);
+	return answered==requests ? 0 : -1;
+}
+
+#endif
+
+int main(int argc, char** argv)
+
+{
+	struct search_context ctx;
+	struct tree_node *solution_node=NULL;
+	int method;				// The search algorithm that will be used to solve the puzzle.
+	int initial_value, target_value;
+	char* p;
+	char* p1;
+	unsigned long long bench_seed=BENCH_SEED;
+	int timeout_given=0;
+	int status;
+
+	// Reading the options that precede the method
+	while (argc>2 && strncmp(argv[1],"--",2)==0)
+	{
+		if (strcmp(argv[1],"--frontier")==0)
+		{
+			frontier_kind=get_frontier_kind(argv[2]);
+			if (frontier_kind<0)
+			{
+				printf("Wrong frontier. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--duplicates")==0)
+		{
+			duplicate_kind=get_duplicate_kind(argv[2]);
+			if (duplicate_kind<0)
+			{
+				printf("Wrong duplicate detection. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--nodes")==0)
+		{
+			node_kind=get_node_kind(argv[2]);
+			if (node_kind<0)
+			{
+				printf("Wrong node layout. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--table")==0)
+		{
+			if (table.base==NULL && load_table(argv[2])<0)
+			{
+				printf("Cannot map the table file %s.\n",argv[2]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--cache")==0)
+		{
+			if (cache.base==NULL && load_cache(argv[2])<0)
+			{
+				printf("Cannot map the cache file %s.\n",argv[2]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--landmarks")==0)
+		{
+			if (landmarks.base==NULL && load_landmarks(argv[2])<0)
+			{
+				printf("Cannot map the landmark file %s.\n",argv[2]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--search-threads")==0)
+		{
+			search_threads=atoi(argv[2]);
+			if (search_threads<0)
+			{
+				printf("Wrong number of threads. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--portfolio")==0)
+		{
+			if (strcmp(argv[2],"first")!=0 && strcmp(argv[2],"best")!=0)
+			{
+				printf("Wrong portfolio mode. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+			portfolio_mode = strcmp(argv[2],"best")==0 ? PORTFOLIO_BEST : PORTFOLIO_FIRST;
+		}
+		else if (strcmp(argv[1],"--portfolio-methods")==0)
+		{
+			if (get_portfolio_methods(argv[2])<0)
+			{
+				printf("Wrong portfolio methods. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--stats")==0)
+		{
+			if (strcmp(argv[2],"text")!=0)
+			{
+				printf("Wrong statistics. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+			stats_text=1;
+		}
+		else if (strcmp(argv[1],"--format")==0)
+		{
+			if (strcmp(argv[2],"text")!=0 && strcmp(argv[2],"binary")!=0)
 			{
-				pt->previous->next=new_frontier_node;
-				new_frontier_node->next=pt;
-				new_frontier_node->previous=pt->previous;
-				pt->previous=new_frontier_node;
+				printf("Wrong format. Use correct syntax:\n");
+				syntax_message();
+				return -1;
 			}
-			else
+			binary_replies = strcmp(argv[2],"binary")==0;
+		}
+		else if (strcmp(argv[1],"--stats-json")==0)
+		{
+			stats_json = strcmp(argv[2],"-")==0 ? stdout : fopen(argv[2],"a");
+			if (stats_json==NULL)
 			{
-				// In this case, new_frontier_node becomes the first node of the frontier.
-				new_frontier_node->next=pt;
-				pt->previous=new_frontier_node;
-				frontier_head=new_frontier_node;
+				printf("Cannot open the statistics file %s.\n",argv[2]);
+				return -1;
 			}
 		}
-		else
+		else if (strcmp(argv[1],"--timeout")==0)
 		{
-			// if pt==NULL, new_frontier_node is inserted at the back of the frontier
-			frontier_tail->next=new_frontier_node;
-			new_frontier_node->previous=frontier_tail;
-			frontier_tail=new_frontier_node;
+			time_limit=atof(argv[2]);
+			timeout_given=1;
+			if (time_limit<=0)
+			{
+				printf("Wrong time limit. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
 		}
-	}
-
-	return 0;
-}
-
-//This functions calculated the f function for astar method
-int f(int g,int h,int method){
-	if(method==astar) return g+h/2;
-	 return 0;
-	
-	}
-// This function expands a leaf-node of the search tree.
-// A leaf-node may have up to 4 childs. A table with 4 pointers
-// to these childs is created, with NULLs for those childrens that do not exist.
-// In case no child exists (due to loop-detections), the table is not created
-// and a 'higher-level' NULL indicates this situation.
-// Inputs:
-//		struct tree_node *current_node	: A leaf-node of the search tree.
-// Output:
-//		The same leaf-node expanded with pointers to its children (if any).
-int find_children(struct tree_node *current_node, int method)
-{
-	int x;
-
-
-	// Operation: Root
-	if (current_node->node_value>1 && (floor(sqrt(current_node->node_value))==sqrt(current_node->node_value)))
-	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) return -1;
-
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = Root;                     //The operation
-		child->node_value= sqrt(current_node->node_value) ;
-		x=child->parent->node_value; 
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + ((x - sqrt(x))/4)+1; //The total cost of operations until the node
-
-
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
-		else
+		else if (strcmp(argv[1],"--max-expanded")==0)
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			max_expanded=strtol(argv[2], &p, 10);
+			if (*p!='\0' || max_expanded<=0)
+			{
+				printf("Wrong node limit. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
 		}
-
-	}
-	
-	
-    // Operation: square
-	if ((current_node->node_value^2)>10^9)
-	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) return -1;
-
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = square;                     //The operation
-		child->node_value= pow(current_node->node_value,2) ;
-		x=child->parent->node_value; 
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + ((pow(x,2) - x )/4) +1; //The total cost of operations until the node
-
-
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
-		else
+		else if (strcmp(argv[1],"--max-memory")==0)
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			max_memory=parse_bytes(argv[2]);
+			if (max_memory<=0)
+			{
+				printf("Wrong memory limit. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
 		}
-
-	}
-	
-	
-    // Operation: half
-	if (current_node->node_value>0)
-	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) return -1;
-
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = half;                     //The operation
-		child->node_value= floor(current_node->node_value/2); 
-		x=child->parent->node_value; 
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + ceil(x/4)+1; //The total cost of operations until the node
-
-
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
-		else
+		else if (strcmp(argv[1],"--weight")==0)
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			ara_weight=atof(argv[2]);
+			if (ara_weight<1)
+			{
+				printf("Wrong weight. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--seed")==0)
+			bench_seed=strtoull(argv[2], NULL, 10);
+		else if (strcmp(argv[1],"--tolerance")==0)
+		{
+			bench_tolerance=atof(argv[2]);
+			if (bench_tolerance<1)
+			{
+				printf("Wrong tolerance. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
+		}
+		else if (strcmp(argv[1],"--threads")==0)
+		{
+			thread_count=atoi(argv[2]);
+			if (thread_count==0)
+				thread_count=cpu_count();
+			if (thread_count<0)
+			{
+				printf("Wrong number of threads. Use correct syntax:\n");
+				syntax_message();
+				return -1;
+			}
 		}
-
-	}
-	
-    // Operation: double
-	if (current_node->node_value>0 && 2*current_node->node_value<=10^9 )
-	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) return -1;
-
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = Double;                     //The operation
-		child->node_value= current_node->node_value*2 ;
-		x=child->parent->node_value; 
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + ceil(x/2)+1; //The total cost of operations until the node
-
-
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
 		else
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			printf("Unknown option %s. Use correct syntax:\n",argv[1]);
+			syntax_message();
+			return -1;
 		}
-
+		argc-=2;
+		argv+=2;
 	}
-	
-	
-	 // Operation: decrease
-	if (current_node->node_value>0 )
-	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) {printf("child null"); return -1 ;}
-
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = decrease;                     //The operation
-		child->node_value= current_node->node_value - 1 ;
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + 2; //The total cost of operations until the node
 
+	if (argc==5 && strcmp(argv[1],"targets")==0)
+	{
+		long value=strtol(argv[2], &p, 10);
+		int err;
 
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
-		else
+		if (*p!='\0' || value<0 || value>MAX_VALUE)
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			printf("Wrong initial value. Use correct syntax:\n");
+			syntax_message();
+			return -1;
 		}
-
+		err=solve_targets((int) value, argv[3], argv[4]);
+		unload_cache();
+		unload_table();
+		unload_landmarks();
+		return err;
 	}
-	
-	
-	 // Operation: increase
-	if (current_node->node_value<10^9 )
+
+	if (argc==4 && strcmp(argv[1],"batch")==0)
 	{
-		// Initializing the new child
-		struct tree_node *child=(struct tree_node*) malloc(sizeof(struct tree_node));
-		if (child==NULL) return -1;
+		int err=solve_batch(argv[2], argv[3]);
+		unload_cache();
+		unload_table();
+		unload_landmarks();
+		return err;
+	}
 
-		child->parent = current_node;                 //The parent of the created node
-		child->operation = increase;                     //The operation
-		child->node_value= current_node->node_value + 1 ;
-		child->node_depth = current_node->node_depth + 1;		// The depth of the new child
-		child->g = current_node->g + 2; //The total cost of operations until the node
+#ifndef _WIN32
+	if (argc==3 && strcmp(argv[1],"serve")==0)
+	{
+		int err=serve(argv[2]);
+		unload_cache();
+		unload_table();
+		unload_landmarks();
+		return err;
+	}
 
+	if (argc==5 && strcmp(argv[1],"client")==0)
+		return run_client(argv[2], argv[3], argv[4]);
 
-		// Check for loops
-		if (!check_with_parents(child))
-			// In case of loop detection, the child is deleted
-			free(child);
-		else
+	if (argc==6 && strcmp(argv[1],"loadgen")==0)
+	{
+		long requests=strtol(argv[4], &p, 10), connections;
+		if (*p=='\0' && requests>0)
 		{
-			// Computing the heuristic value
-			child->h=heuristic(child->node_value);
-			if (method==best)
-				child->f = child->h;
-			else if (method==astar)
-				child->f = f(child->g,child->h,method);
-			else
-				child->f = 0;
-
-            int err=0;
-            if (method==depth)
-				err=add_frontier_front(child);
-			else if (method==breadth)
-				err=add_frontier_back(child);
-			else if (method==best || method==astar)
-				err=add_frontier_in_order(child);
-			if (err<0)
-                return -1;
+			connections=strtol(argv[5], &p, 10);
+			if (*p=='\0' && connections>0 && connections<=requests && connections<=1024)
+				return run_loadgen(argv[2], argv[3], requests, connections);
 		}
-
+		printf("Wrong number of requests or connections. Use correct syntax:\n");
+		syntax_message();
+		return -1;
 	}
-	return 1;
-}
-
-// Auxiliary function that displays a message in case of wrong input parameters.
-void syntax_message()
-{
-	printf("Syntax of the main call: \n");
-	printf("Register2023 <method> <initial number> <target value> <output-file>\n\n");
-	printf("where: ");
-	printf("<method> = breadth|depth|best|astar\n");
-	printf("<initial number> is the positive integer number of the root of the tree.\n");
-	printf("<target value> is the positive integer target value of the search algorithm.\n");
-	printf("<output-file> is the output file where the solution and the steps will be extracted.\n");
-	printf("example : register.exe breadth 5 18 solution.txt.\n");
-}
-
-// This function checks whether a puzzle is a solution puzzle.
-// Inputs:
-//		int p[N][N]		: A puzzle
-// Outputs:
-//		1 --> The puzzle is a solution puzzle
-//		0 --> The puzzle is NOT a solution puzzle
-int is_solution(int node_value)
-{
-	if(node_value==target_value)return 1;
-	return 0;
-}
-
-// Giving a (solution) leaf-node of the search tree, this function computes
-// the moves of the blank that have to be done, starting from the root puzzle,
-// in order to go to the leaf node's puzzle.
-// Inputs:
-//		struct tree_node *solution_node	: A leaf-node
-// Output:
-//		The sequence of blank's moves that have to be done, starting from the root puzzle,
-//		in order to receive the leaf-node's puzzle, is stored into the global variable solution.
-void extract_solution(struct tree_node *solution_node)
-{
-	int i;
+#endif
 
-	struct tree_node *temp_node=solution_node;
-	solution_length = solution_node->node_depth;
-
-	solution= (struct tree_node*) malloc(solution_length*sizeof(struct tree_node));
-	temp_node=solution_node;
-	i=solution_length;
-	while (temp_node->parent!=NULL)
+	if (argc==4 && strcmp(argv[1],"benchmark")==0)
 	{
-		i--;
-		solution[i] = *temp_node;
-		temp_node=temp_node->parent;
+		if (!timeout_given)
+			time_limit=BENCH_TIME_LIMIT;
+		return benchmark(bench_seed, argv[2], argv[3]);
 	}
-}
 
-// This function writes the solution into a file
-// Inputs:
-//		char* filename	: The name of the file where the solution will be written.
-// Outputs:
-//		Nothing (apart from the new file)
-void write_solution_to_file(char* filename, int solution_length,struct tree_node *solution)
-{
-	int i;
-	FILE *fout;
-	fout=fopen(filename,"w");
-	if (fout==NULL)
+	if (argc==5 && (strcmp(argv[1],"hdabench")==0 || strcmp(argv[1],"levelbench")==0))
 	{
-		printf("Cannot open output file to write solution.\n");
-		printf("Now exiting...");
-		return;
-	}
-	fprintf(fout,"%d, %d\n",solution_length,solution[solution_length-1].g);
-	for (i=0;i<solution_length;i++)
-		switch(solution[i].operation)
+		long values[3];
+		int i;
+		for (i=0;i<3;i++)
 		{
-		case increase:
-			fprintf(fout,"increase %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g);
-			break;
-		case decrease:
-			fprintf(fout,"decrease %d %d\n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
-			break;
-		case Double:
-			fprintf(fout,"double %d %d\n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
-			break;
-		case half:
-			fprintf(fout,"half %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
-			break;
-		case square:
-			fprintf(fout,"square %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g) ;
-			break;
-		case Root:
-			fprintf(fout,"root %d %d \n" ,solution[i].parent->node_value,solution[i].g - solution[i].parent->g );
-			break;
-			
-			
+			values[i]=strtol(argv[i+2], &p, 10);
+			if (*p!='\0' || values[i]<0 || values[i]>INT_MAX)
+				break;
+		}
+		if (i==3 && values[2]>0)
+			return benchmark_parallel(strcmp(argv[1],"hdabench")==0 ? hdastar : pbreadth, values[0], values[1], values[2]);
+		printf("Wrong arguments of %s. Use correct syntax:\n",argv[1]);
+		syntax_message();
+		return -1;
 	}
-	fclose(fout);
-}
-
-// This function initializes the search, i.e. it creates the root node of the search tree
-// and the first node of the frontier.
-void initialize_search(int initial_value, int method)
-{
-	struct tree_node *root=(struct tree_node*) malloc(sizeof(struct tree_node));	// the root of the search tree.
-
-	// Initialize search tree
-	root->parent=NULL;
-	root->operation=-1;
-	root->node_value=initial_value;
-	printf("Root node_value: %d\n",root->node_value);
-	root->g=0;
-	root->node_depth=0;
-	root->h=heuristic(root->node_value);
-	if (method==best)
-		root->f=root->h;
-	else if (method==astar)
-		root->f=root->g+root->h;
-	else
-		root->f=0;
-
-	// Initialize frontier
-	add_frontier_front(root);
-}
-
-// This function implements at the higest level the search algorithms.
-// The various search algorithms differ only in the way the insert
-// new nodes into the frontier, so most of the code is commmon for all algorithms.
-// Inputs:
-//		Nothing, except for the global variables root, frontier_head and frontier_tail.
-// Output:
-//		NULL --> The problem cannot be solved
-//		struct tree_node*	: A pointer to a search-tree leaf node that corresponds to a solution.
-struct tree_node *search(int method)
-{
-	clock_t t;
-	int i, err;
-	struct frontier_node *temp_frontier_node;
-	struct tree_node *current_node;
 
-	while (frontier_head!=NULL)
+	if (argc==5 && strcmp(argv[1],"precompute")==0)
 	{
-		t=clock();
-		if (t-t1 > CLOCKS_PER_SEC*TIMEOUT)
+		long target=strtol(argv[2], &p, 10), max_value;
+		if (*p=='\0')
 		{
-			printf("Timeout\n");
-			return NULL;
+			max_value=strtol(argv[3], &p, 10);
+			if (*p=='\0' && target>=0 && max_value>=target && max_value<=MAX_VALUE)
+				return precompute_table(target, max_value, argv[4]);
 		}
-
-		// Extract the first node from the frontier
-		current_node = frontier_head->n;
-
-		if (is_solution(current_node->node_value))
-			return current_node;
-
-		// Delete the first node of the frontier
-		temp_frontier_node=frontier_head;
-		frontier_head = frontier_head->next;
-		free(temp_frontier_node);
-		if (frontier_head==NULL)
-			frontier_tail=NULL;
-		else
-			frontier_head->previous=NULL;
-
-		// Find the children of the extracted node
-		int err=find_children(current_node, method);
-
-		if (err<0)
-	        {
-            		printf("Memory exhausted while creating new frontier node. Search is terminated...\n");
-			return NULL;
-        	}
+		printf("Wrong target or range of the table. Use correct syntax:\n");
+		syntax_message();
+		return -1;
 	}
 
-	return NULL;
-}
-
-int main(int argc, char** argv)
-{
-	int err;
-	struct tree_node *solution_node;
-	int method;				// The search algorithm that will be used to solve the puzzle.
+	if (argc==5 && strcmp(argv[1],"landmarks")==0)
+	{
+		long count=strtol(argv[2], &p, 10), max_value;
+		if (*p=='\0')
+		{
+			max_value=strtol(argv[3], &p, 10);
+			if (*p=='\0' && count>=1 && count<=MAX_LANDMARKS && max_value>=1 && max_value<=MAX_VALUE)
+				return precompute_landmarks(count, max_value, argv[4]);
+		}
+		printf("Wrong number of landmarks or range. Use correct syntax:\n");
+		syntax_message();
+		return -1;
+	}
 
 	if (argc!=5)
 	{
@@ -717,15 +6991,13 @@ int main(int argc, char** argv)
 		syntax_message();
 		return -1;
 	}
-	char* p;
-	char* p1;
     long value1 = strtol(argv[2], &p, 10);
     if (*p != '\0') {
 	    syntax_message();  // an invalid character was found before the end of the string
 	     return -1;
 	}  
 	initial_value=value1;
-	printf("initial value: %d, ",value1);
+	printf("initial value: %ld, ",value1);
 		 
     long value2 = strtol(argv[3], &p1, 10);
     if (*p1 != '\0') {
@@ -733,35 +7005,53 @@ int main(int argc, char** argv)
 		return -1;
 	 }
 		  target_value=value2;
-		  printf("target value: %d, ",value2);
+		  printf("target value: %ld, ",value2);
 		  
 	//Setting values for initial_time and target_value base on the call
-	if(initial_value<0||target_value==0){
-		printf("\n Error: Only positive integers as input... Try again \n\n");
+	if(value1<0||value2==0||value1>MAX_VALUE||value2>MAX_VALUE){
+		printf("\n Error: Only positive integers up to %d as input... Try again \n\n",MAX_VALUE);
 		syntax_message();
 		return -1;
 	}
 
 	printf("Solving %s to %s using %s...\n",argv[2],argv[3],argv[1]);
-	t1=clock();
+	printf("Root node_value: %d\n",initial_value);
 
-	initialize_search(initial_value, method);
-
-	solution_node = search(method);			// The main call
-
-	t2=clock();
+	init_search_context(&ctx);
+	if (initialize_search(&ctx, initial_value, target_value, method)==0)
+		solution_node = search(&ctx);			// The main call
 
 	if (solution_node!=NULL)
-		extract_solution(solution_node);
+		extract_solution(&ctx, solution_node);
 	else
 		printf("No solution found.\n");
+	end_search(&ctx);
 
 	if (solution_node!=NULL)
 	{
-		printf("Solution found! (%d steps)\n",solution_length);
-		printf("Time spent: %f secs\n",((float) t2-t1)/CLOCKS_PER_SEC);
-		write_solution_to_file(argv[4], solution_length, solution);
+		printf("Solution found! (%d steps)\n",ctx.solution_length);
+		if (ctx.stats.winner)
+			printf("Portfolio won by %s\n",method_name(ctx.stats.winner));
+		printf("Time spent: %f secs\n",ctx.t2-ctx.t1);
+		if (ctx.t2>ctx.t1)
+			printf("Nodes expanded: %ld (%.0f nodes/sec)\n",ctx.expanded_nodes,
+				ctx.expanded_nodes/(ctx.t2-ctx.t1));
+		else
+			printf("Nodes expanded: %ld\n",ctx.expanded_nodes);
+		write_solution_to_file(argv[4], ctx.solution_length, ctx.solution);
 	}
+	if (stats_text || ctx.stats.stopped)
+		print_stats(stdout, &ctx.stats);
+	if (stats_json!=NULL)
+		write_stats_json(stats_json, 1, method, initial_value, target_value,
+			solution_node!=NULL, ctx.solution_length, ctx.solution, &ctx.stats);
+	status=exit_status(&ctx.stats);
+	free_search_context(&ctx);
+	if (cache.base!=NULL)
+		print_cache_stats(stdout);
+	unload_cache();
+	unload_table();
+	unload_landmarks();
 
-	return 0;
+	return status;
 }